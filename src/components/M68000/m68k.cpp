@@ -7,23 +7,87 @@
  */
 
 #include "m68k.hpp"
+#include "common.hpp"
+
+E64::m68k_ic::m68k_ic()
+{
+	available = false;
+	reset_registers();
+}
+
+void E64::m68k_ic::set_available(bool value)
+{
+	available = value;
+	if (!available) control = 0x00;
+}
+
+void E64::m68k_ic::reset_registers()
+{
+	control = 0x00;
+	boot_area = 0x01;
+	cycle_saldo = 0;
+}
+
+void E64::m68k_ic::run(int32_t cycles)
+{
+	if (!running()) return;
+	
+	cycle_saldo += cycles;
+	int64_t end = getClock() + cycle_saldo;
+	while (getClock() < end) execute();
+	cycle_saldo = (int32_t)(end - getClock());
+}
+
+uint8_t E64::m68k_ic::io_read_byte(uint8_t address)
+{
+	switch (address) {
+		case 0x00:
+			return (available ? 0x80 : 0x00) | (control & 0x01);
+		case 0x01:
+			return boot_area;
+		default:
+			return 0x00;
+	}
+}
+
+void E64::m68k_ic::io_write_byte(uint8_t address, uint8_t byte)
+{
+	switch (address) {
+		case 0x00:
+			if (!available) break;
+			if ((byte & 0x01) && !(control & 0x01)) {
+				// released, fetches ssp and pc from the boot area
+				cycle_saldo = 0;
+				reset();
+			}
+			control = byte & 0x01;
+			break;
+		case 0x01:
+			boot_area = byte;
+			break;
+		default:
+			break;
+	}
+}
 
 u8 E64::m68k_ic::read8(u32 addr)
 {
-	return 0;
+	return machine.blitter->video_memory_read_8(physical(addr));
 }
 
 u16 E64::m68k_ic::read16(u32 addr)
 {
-	return 0;
+	return (machine.blitter->video_memory_read_8(physical(addr)) << 8) |
+		machine.blitter->video_memory_read_8(physical(addr + 1));
 }
 
 void E64::m68k_ic::write8 (u32 addr, u8 val)
 {
-	//
+	machine.blitter->video_memory_write_8(physical(addr), val);
 }
 
 void E64::m68k_ic::write16(u32 addr, u16 val)
 {
-	//
+	machine.blitter->video_memory_write_8(physical(addr), val >> 8);
+	machine.blitter->video_memory_write_8(physical(addr + 1), val & 0xff);
 }
@@ -16,11 +16,72 @@ using namespace moira;
 namespace E64
 {
 
+/*
+ *  Register 0x00 - 68000 Control Register
+ *
+ *  7 6 5 4 3 2 1 0
+ *  |             |
+ *  |             +-- Held in reset (0) / Running (1) (READ/WRITE)
+ *  +---------------- Not available (0) / Available (1) (READ ONLY)
+ *
+ *  bits 1-6: Reserved
+ *
+ *  Releasing the 68000 from reset makes it fetch its initial SSP and PC
+ *  from the first 8 bytes of its boot area. A machine reset holds it in
+ *  reset again.
+ *
+ *
+ *  Register 0x01 - Boot Area, bits 16-23 of the physical address the
+ *  68000 sees at its address 0 (READ/WRITE). The 68000 sees all 16mb of
+ *  video memory from there, wrapping around. After a machine reset it
+ *  is 0x01 (physical $010000), outside the 64kb the 6809 sees after a
+ *  reset.
+ */
+
+/*
+ * The 24 bit address bus of the 68000 covers the 16mb of video memory
+ * exactly, so it sees the same physical ram as the mmu of the 6809 and
+ * the blitter. Writes go through the blitter, just like those of the
+ * 6809 into tile, color and pixel ram, which also invalidates any
+ * predecoded 6809 code there.
+ */
 class m68k_ic : public Moira {
+private:
 	u8  read8 (u32 addr) override;
 	u16 read16(u32 addr) override;
 	void write8 (u32 addr, u8  val) override;
 	void write16(u32 addr, u16 val) override;
+	
+	bool available;
+	uint8_t control;
+	uint8_t boot_area;
+	int32_t cycle_saldo;
+	
+	inline u32 physical(u32 address) { return (address + (boot_area << 16)) & 0xffffff; }
+public:
+	m68k_ic();
+	
+	/*
+	 * Only an available 68000 (a host setting) can be released by the
+	 * guest, and takes host time. Taking it away holds it in reset.
+	 */
+	void set_available(bool value);
+	inline bool is_available() { return available; }
+	inline bool running() { return control & 0x01; }
+	
+	/*
+	 * Machine reset, holds the 68000 in reset
+	 */
+	void reset_registers();
+	
+	/*
+	 * Catches up with the 6809 by the same amount of cycles, while
+	 * running. Overshoot of the last instruction is carried over.
+	 */
+	void run(int32_t cycles);
+	
+	uint8_t io_read_byte(uint8_t address);
+	void io_write_byte(uint8_t address, uint8_t byte);
 };
 
 }
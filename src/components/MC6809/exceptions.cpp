@@ -6,14 +6,16 @@
  */
 
 #include "exceptions.hpp"
+#include <cstdio>
 
-E64::exceptions_ic::exceptions_ic()
+E64::exceptions_ic::exceptions_ic(uint64_t (*clock_function)(void *context), void *context)
 {
-	for(int i=0; i<8; i++) {
-		irq_input_pins[i] = true;
-	}
+	clock = clock_function;
+	clock_context = context;
+	pending = 0;
 	next_available_device = 0;
 	nmi_output_pin = true;
+	reset_latencies();
 	update_status();
 }
 
@@ -25,27 +27,61 @@ uint8_t E64::exceptions_ic::connect_device()
 	return return_value;
 }
 
-void E64::exceptions_ic::update_status()
+void E64::exceptions_ic::pull(uint8_t device)
 {
-	bool result =	(!(irq_input_pins[0])) |
-			(!(irq_input_pins[1])) |
-			(!(irq_input_pins[2])) |
-			(!(irq_input_pins[3])) |
-			(!(irq_input_pins[4])) |
-			(!(irq_input_pins[5])) |
-			(!(irq_input_pins[6])) |
-			(!(irq_input_pins[7])) ;
-	irq_output_pin = !result;
+	device &= 0x7;
+	
+	/*
+	 * A repeated pull doesn't restart the measurement, latency counts
+	 * from the first assertion.
+	 */
+	if (!(pending & (0b1 << device))) {
+		pending |= (0b1 << device);
+		latencies[device].asserted_at = now();
+		update_status();
+	}
 }
 
-void E64::exceptions_ic::pull(uint8_t device)
+void E64::exceptions_ic::release(uint8_t device)
 {
-	irq_input_pins[device & 0x7] = false;
-	update_status();
+	device &= 0x7;
+	
+	if (pending & (0b1 << device)) {
+		pending &= ~(0b1 << device);
+		
+		/*
+		 * The clock restarts on a machine reset, a line
+		 * released after that isn't counted.
+		 */
+		uint64_t released_at = now();
+		if (released_at >= latencies[device].asserted_at) {
+			uint64_t latency = released_at - latencies[device].asserted_at;
+			latencies[device].acknowledged++;
+			latencies[device].total += latency;
+			if (latency > latencies[device].max) {
+				latencies[device].max = latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency;
+			}
+		}
+		update_status();
+	}
 }
 
-void E64::exceptions_ic::release(uint8_t device)
+void E64::exceptions_ic::reset_latencies()
 {
-	irq_input_pins[device & 0x7] = true;
-	update_status();
+	for (int i=0; i<8; i++) {
+		latencies[i] = { 0, 0, 0, 0 };
+	}
+}
+
+void E64::exceptions_ic::status(char *buffer, uint8_t device)
+{
+	device &= 0x7;
+	
+	snprintf(buffer, 64, "\nirq%u:%c acks:%8u avg:%8llu max:%8u",
+		 device,
+		 irq_input_pin(device) ? '1' : '0',
+		 latencies[device].acknowledged,
+		 latencies[device].acknowledged ?
+		 (unsigned long long)(latencies[device].total / latencies[device].acknowledged) : 0ULL,
+		 latencies[device].max);
 }
@@ -5,6 +5,17 @@
  *  Copyright © 2019-2022 elmerucr. All rights reserved.
  */
 
+/*
+ * Collects the irq lines of up to 8 devices into one bitmask of pending
+ * sources. The output pins only change on a pull or release, and a single
+ * attention flag tells the cpu whether any of its lines is low at all, so
+ * it doesn't need to check them while nothing is going on.
+ *
+ * For each source, the time from assertion (first pull) to acknowledge
+ * (release) is measured in cycles of a clock supplied by the embedder.
+ * Without a clock, only the number of acknowledges is counted.
+ */
+
 #ifndef EXCEPTIONS_HPP
 #define EXCEPTIONS_HPP
 
@@ -13,18 +24,52 @@
 namespace E64
 {
 
+struct irq_latency {
+	uint64_t asserted_at;
+	uint32_t acknowledged;
+	uint64_t total;
+	uint32_t max;
+};
+
 class exceptions_ic {
 private:
 	uint8_t next_available_device;
-	void update_status();
+	uint8_t pending;		// bit set for each pulled device
+	
+	uint64_t (*clock)(void *context);
+	void *clock_context;
+	struct irq_latency latencies[8];
+	
+	inline uint64_t now() { return clock ? clock(clock_context) : 0; }
+	
+	inline void update_status() {
+		irq_output_pin = !pending;
+		attention = !(irq_output_pin && nmi_output_pin);
+	}
 public:
-	bool irq_input_pins[8];
-	exceptions_ic();
+	/*
+	 * clock(context) returns the current cycle count, used for the
+	 * latency measurements.
+	 */
+	exceptions_ic(uint64_t (*clock_function)(void *context) = nullptr, void *context = nullptr);
+	
 	bool irq_output_pin;
 	bool nmi_output_pin;
+	
+	/*
+	 * True whenever one of the output pins is low. Assigned to the cpu
+	 * as its attention line.
+	 */
+	bool attention;
+	
 	uint8_t connect_device();
 	void pull(uint8_t device);
 	void release(uint8_t device);
+	
+	inline bool irq_input_pin(uint8_t device) { return !(pending & (0b1 << (device & 0x7))); }
+	
+	void reset_latencies();
+	void status(char *buffer, uint8_t device);
 };
 
 }
@@ -8,8 +8,6 @@
  * MC6809 version 0.9 - October 2021
  *
  * October 2021. Most functionality is in there. Currently missing:
- * - CWAI instruction
- * - SYNC instruction
  * - illegal opcode exception implementation
  *
  * Note:
@@ -36,6 +34,26 @@
 #define	F_FLAG	0x40	// firq
 #define	E_FLAG	0x80	// entire state on stack
 
+/*
+ * Block translation parameters, see mc6809_run_cpp.hpp
+ */
+#define MC6809_BLOCK_INSTRUCTIONS	16
+#define MC6809_BLOCK_BYTES		(5 * MC6809_BLOCK_INSTRUCTIONS)
+#define MC6809_BLOCK_POOL		2048
+#define MC6809_BLOCK_HEAT		16
+#define MC6809_IDLE_IO			4	// max i/o bytes an idle block reads
+
+/*
+ * Native code for hot blocks, see mc6809_jit_cpp.hpp
+ */
+#if defined(__x86_64__) && defined(__linux__)
+#define MC6809_JIT
+#endif
+#define MC6809_JIT_HEAT			64
+#define MC6809_JIT_BUFFER		(4 * 1024 * 1024)
+#define MC6809_JIT_BLOCK_SIZE		16384	// max code for one block
+#define MC6809_JIT_PAGE			4096	// host page size, for mprotect()
+
 #define	VECTOR_ILL_OPC	0xfff0	// originally from 6309
 #define	VECTOR_SWI3	0xfff2
 #define	VECTOR_SWI2	0xfff4
@@ -45,22 +63,42 @@
 #define	VECTOR_NMI	0xfffc
 #define	VECTOR_RESET	0xfffe
 
-class mc6809 {
+/*
+ * The cpu is a template on its memory bus. A bus policy is a class with
+ * member functions
+ *
+ *	uint8_t read_8(uint16_t address);
+ *	void write_8(uint16_t address, uint8_t byte);
+ *
+ * which are called directly, so they can be inlined into the instruction
+ * handlers. mc6809_callback_bus is the original interface using function
+ * pointers, mc6809 is the cpu with that bus.
+ */
+class mc6809_callback_bus {
 public:
-	/*
-	 * read/write callbacks to memory bus
-	 */
 	typedef uint8_t (*bus_read)(uint16_t);
 	typedef void (*bus_write)(uint16_t, uint8_t);
-	bus_read read_8;
-	bus_write write_8;
 
+	mc6809_callback_bus(bus_read r, bus_write w) { read = r; write = w; }
+
+	inline uint8_t read_8(uint16_t address) { return (*read)(address); }
+	inline void write_8(uint16_t address, uint8_t byte) { (*write)(address, byte); }
+private:
+	bus_read read;
+	bus_write write;
+};
+
+template <class bus_t>
+class mc6809_t {
+public:
 	/*
-	 * Constructor receives function pointers for memory calls
+	 * Constructor arguments are passed on to the bus policy, e.g.
+	 * function pointers for memory calls with mc6809_callback_bus.
 	 */
-	mc6809(bus_read r, bus_write w);
+	template <typename... args_t>
+	mc6809_t(args_t... args) : bus(args...) { init(); }
 
-	~mc6809();
+	~mc6809_t();
 
 	/*
 	 * Assignment of the different interrupt lines. The constructor of the
@@ -71,6 +109,13 @@ public:
 	void assign_firq_line(bool *line) { firq_line = line; }
 	void assign_irq_line(bool *line) { irq_line = line; }
 
+	/*
+	 * The interrupt lines are only checked while the attention line is
+	 * true, which must be the case whenever any of them is low. If none
+	 * is assigned, the lines are checked before every instruction.
+	 */
+	void assign_attention_line(bool *line) { attention_line = line; }
+
 	/*
 	 * Reset exception. Doesn't emulate the number of cycles taken.
 	 */
@@ -83,6 +128,74 @@ public:
 	 */
 	uint8_t execute();
 
+	/*
+	 * Alternative execution engine (mc6809_run_cpp.hpp). Runs a block of
+	 * instructions until at least no_of_cycles are consumed, or until
+	 * pc hits a breakpoint. Returns the number of cycles consumed.
+	 * Cycle counts are identical to calling execute() repeatedly.
+	 *
+	 * Hot code is executed as translated blocks, without polling the
+	 * interrupt lines in between instructions. This assumes that lines
+	 * are only pulled low by devices running in between calls, memory
+	 * writes by the cpu itself may only release them.
+	 */
+	uint32_t run(uint32_t no_of_cycles);
+
+	/*
+	 * Lowers the budget of a run() in progress to at most no_of_cycles
+	 * from now, e.g. when a device reschedules an event after a write.
+	 * A translated block that is executing is still finished.
+	 */
+	inline void limit_run(uint32_t no_of_cycles) {
+		if ((int32_t)(cycles + no_of_cycles - run_end) < 0) run_end = cycles + no_of_cycles;
+	}
+
+	/*
+	 * Idle loops. A loop of loads, tests and compares that branches
+	 * back to itself without writing anything, only waits for the
+	 * value it reads to be changed by a device. When enabled, run()
+	 * skips the rest of its budget (in whole iterations) once such a
+	 * loop has made one full pass. Only valid when reads can't change
+	 * value during a run, i.e. devices act in between calls to run().
+	 */
+	inline void set_idle_loops(bool enabled) { idle_loops = enabled; }
+	inline uint64_t idle_cycles_skipped() { return idle_cycles; }
+
+	/*
+	 * Reads from uncacheable (i/o) pages are taken to have side effects,
+	 * unless check(context, address) tells otherwise. An idle loop
+	 * reading i/o is only skipped while the check holds for all its
+	 * reads, e.g. a status register, or a fifo while it's empty. It is
+	 * asked again before every skip.
+	 */
+	inline void assign_side_effect_free_read(bool (*check)(void *context, uint16_t address), void *context)
+	{
+		side_effect_free_read = check;
+		side_effect_free_context = context;
+	}
+
+	/*
+	 * Native code (x86-64 Linux hosts only, a no-op elsewhere). When
+	 * enabled, run() compiles blocks that keep being entered into host
+	 * code. Reads and writes of pages mapped here are done directly on
+	 * host memory, a nullptr sends them through the bus. A mapped write
+	 * page must behave like plain ram: the only other effect of a write
+	 * is a predecode_invalidate() of the same address. The embedder
+	 * keeps the map in sync with its own.
+	 */
+	inline void set_jit(bool enabled) { jit = enabled && (jit_buffer != nullptr); }
+	inline bool jit_enabled() { return jit; }
+	inline void jit_map_page(uint8_t page, uint8_t *read, uint8_t *write)
+	{
+		jit_read_page[page] = read;
+		jit_write_page[page] = write;
+	}
+
+	/*
+	 * After cwai or sync the cpu is halted until an interrupt occurs
+	 */
+	inline bool halted() { return state != STATE_NORMAL; }
+
 	void status(char *text_buffer);
 	void stacks(char *text_buffer, int no);
 	uint16_t disassemble_instruction(char *buffer, uint16_t address);
@@ -92,35 +205,35 @@ public:
 	inline bool is_e_flag_clear() { return (cc & E_FLAG) ? false : true ; }
 	inline bool is_f_flag_set()   { return (cc & F_FLAG) ? true  : false; }
 	inline bool is_f_flag_clear() { return (cc & F_FLAG) ? false : true ; }
-	inline bool is_h_flag_set()   { return (cc & H_FLAG) ? true  : false; }
-	inline bool is_h_flag_clear() { return (cc & H_FLAG) ? false : true ; }
+	inline bool is_h_flag_set()   { materialize_flags(); return (cc & H_FLAG) ? true  : false; }
+	inline bool is_h_flag_clear() { materialize_flags(); return (cc & H_FLAG) ? false : true ; }
 	inline bool is_i_flag_set()   { return (cc & I_FLAG) ? true  : false; }
 	inline bool is_i_flag_clear() { return (cc & I_FLAG) ? false : true ; }
-	inline bool is_n_flag_set()   { return (cc & N_FLAG) ? true  : false; }
-	inline bool is_n_flag_clear() { return (cc & N_FLAG) ? false : true ; }
-	inline bool is_z_flag_set()   { return (cc & Z_FLAG) ? true  : false; }
-	inline bool is_z_flag_clear() { return (cc & Z_FLAG) ? false : true ; }
-	inline bool is_v_flag_set()   { return (cc & V_FLAG) ? true  : false; }
-	inline bool is_v_flag_clear() { return (cc & V_FLAG) ? false : true ; }
-	inline bool is_c_flag_set()   { return (cc & C_FLAG) ? true  : false; }
-	inline bool is_c_flag_clear() { return (cc & C_FLAG) ? false : true ; }
+	inline bool is_n_flag_set()   { materialize_flags(); return (cc & N_FLAG) ? true  : false; }
+	inline bool is_n_flag_clear() { materialize_flags(); return (cc & N_FLAG) ? false : true ; }
+	inline bool is_z_flag_set()   { materialize_flags(); return (cc & Z_FLAG) ? true  : false; }
+	inline bool is_z_flag_clear() { materialize_flags(); return (cc & Z_FLAG) ? false : true ; }
+	inline bool is_v_flag_set()   { materialize_flags(); return (cc & V_FLAG) ? true  : false; }
+	inline bool is_v_flag_clear() { materialize_flags(); return (cc & V_FLAG) ? false : true ; }
+	inline bool is_c_flag_set()   { materialize_flags(); return (cc & C_FLAG) ? true  : false; }
+	inline bool is_c_flag_clear() { materialize_flags(); return (cc & C_FLAG) ? false : true ; }
 
 	inline void set_e_flag()   { cc |= E_FLAG; }
 	inline void clear_e_flag() { cc &= (0xff - E_FLAG); }
 	inline void set_f_flag()   { cc |= F_FLAG; }
 	inline void clear_f_flag() { cc &= (0xff - F_FLAG); }
-	inline void set_h_flag()   { cc |= H_FLAG; }
-	inline void clear_h_flag() { cc &= (0xff - H_FLAG); }
+	inline void set_h_flag()   { lazy_mask &= ~H_FLAG; cc |= H_FLAG; }
+	inline void clear_h_flag() { lazy_mask &= ~H_FLAG; cc &= (0xff - H_FLAG); }
 	inline void set_i_flag()   { cc |= I_FLAG; }
 	inline void clear_i_flag() { cc &= (0xff - I_FLAG); }
-	inline void set_n_flag()   { cc |= N_FLAG; }
-	inline void clear_n_flag() { cc &= (0xff - N_FLAG); }
-	inline void set_z_flag()   { cc |= Z_FLAG; }
-	inline void clear_z_flag() { cc &= (0xff - Z_FLAG); }
-	inline void set_v_flag()   { cc |= V_FLAG; }
-	inline void clear_v_flag() { cc &= (0xff - V_FLAG); }
-	inline void set_c_flag()   { cc |= C_FLAG; }
-	inline void clear_c_flag() { cc &= (0xff - C_FLAG); }
+	inline void set_n_flag()   { lazy_mask &= ~N_FLAG; cc |= N_FLAG; }
+	inline void clear_n_flag() { lazy_mask &= ~N_FLAG; cc &= (0xff - N_FLAG); }
+	inline void set_z_flag()   { lazy_mask &= ~Z_FLAG; cc |= Z_FLAG; }
+	inline void clear_z_flag() { lazy_mask &= ~Z_FLAG; cc &= (0xff - Z_FLAG); }
+	inline void set_v_flag()   { lazy_mask &= ~V_FLAG; cc |= V_FLAG; }
+	inline void clear_v_flag() { lazy_mask &= ~V_FLAG; cc &= (0xff - V_FLAG); }
+	inline void set_c_flag()   { lazy_mask &= ~C_FLAG; cc |= C_FLAG; }
+	inline void clear_c_flag() { lazy_mask &= ~C_FLAG; cc &= (0xff - C_FLAG); }
 
 	inline void test_n_flag(uint8_t byte) { if (byte &  0x80) set_n_flag(); else clear_n_flag(); }
 	inline void test_z_flag(uint8_t byte) { if (byte == 0x00) set_z_flag(); else clear_z_flag(); }
@@ -151,8 +264,8 @@ public:
 	void     set_us(uint16_t word) { us = word; }
 	uint16_t get_sp()              { return sp; }
 	void     set_sp(uint16_t word) { sp = word; }
-	uint8_t  get_cc()              { return cc; }
-	void     set_cc(uint8_t  byte) { cc = byte; }
+	uint8_t  get_cc()              { materialize_flags(); return cc; }
+	void     set_cc(uint8_t  byte) { cc = byte; lazy_mask = 0; }
 
 	bool *breakpoint_array;
 	inline bool breakpoint() { return breakpoint_array[pc] ? true : false; }
@@ -161,6 +274,25 @@ public:
 
 	inline uint32_t clock_ticks() { return cycles; }
 
+	/*
+	 * Predecode cache. For every address that has been executed it
+	 * holds the decoded instruction (handler, addressing mode, base
+	 * cycles and opcode length incl. page 2/3 prefix). The embedder
+	 * is responsible for keeping it coherent with memory: writes must
+	 * be reported through predecode_invalidate(), any remapping of
+	 * memory must be followed by predecode_flush(). Pages that don't
+	 * behave like memory (e.g. i/o) must be marked uncacheable.
+	 */
+	inline void predecode_invalidate(uint16_t address)
+	{
+		// opcode itself, or 2nd byte of a prefixed opcode
+		predecode_cache[address].generation = 0;
+		predecode_cache[(uint16_t)(address - 1)].generation = 0;
+		if (block_covered[address]) invalidate_blocks(address);
+	}
+	void predecode_flush();
+	void predecode_set_cacheable(uint8_t page, bool cacheable);
+
 private:
 	uint16_t pc;	// program counter
 	uint8_t	 dp;	// direct page register
@@ -173,10 +305,57 @@ private:
 	uint16_t sp;	// hardware stack pointer
 	uint8_t  cc;	// condition code register
 
+	/*
+	 * Lazy condition codes. Hot alu instructions only record the kind
+	 * of operation, its operands and the (unmasked) result. The bits
+	 * in lazy_mask are stale in cc until materialize_flags() computes
+	 * them. Setting or clearing a flag directly takes it out of the
+	 * mask, anything reading or replacing cc as a whole must call
+	 * materialize_flags() first.
+	 */
+	enum lazy_kind : uint8_t {
+		LAZY_LOGIC_8,	// n, z from result, v cleared
+		LAZY_LOGIC_16,
+		LAZY_ADD_8,	// h, n, z, v, c from op1 + op2 (+ carry)
+		LAZY_SUB_8,	// n, z, v, c from op1 - op2 (- carry)
+		LAZY_ADD_16,
+		LAZY_SUB_16
+	};
+	uint8_t  lazy_kind;
+	uint8_t  lazy_mask;
+	uint16_t lazy_op1;
+	uint16_t lazy_op2;
+	uint32_t lazy_result;
+
+	inline void materialize_flags() { if (lazy_mask) evaluate_flags(); }
+	void evaluate_flags();
+
+	/*
+	 * A pending operation is only evaluated when the new one doesn't
+	 * overwrite all of its flags (e.g. lda after adda keeps h and c).
+	 */
+	inline void lazy_flags(uint8_t kind, uint8_t mask, uint16_t op1, uint16_t op2, uint32_t result)
+	{
+		if (lazy_mask & ~mask) evaluate_flags();
+		lazy_kind = kind;
+		lazy_mask = mask;
+		lazy_op1 = op1;
+		lazy_op2 = op2;
+		lazy_result = result;
+	}
+	inline void lazy_logic_8(uint8_t result) { lazy_flags(LAZY_LOGIC_8, N_FLAG|Z_FLAG|V_FLAG, 0, 0, result); }
+	inline void lazy_logic_16(uint16_t result) { lazy_flags(LAZY_LOGIC_16, N_FLAG|Z_FLAG|V_FLAG, 0, 0, result); }
+	inline void lazy_add_8(uint8_t op1, uint8_t op2, uint16_t result) { lazy_flags(LAZY_ADD_8, H_FLAG|N_FLAG|Z_FLAG|V_FLAG|C_FLAG, op1, op2, result); }
+	inline void lazy_inc_dec_8(uint8_t op1, uint8_t op2, uint16_t result) { lazy_flags(LAZY_ADD_8, N_FLAG|Z_FLAG|V_FLAG, op1, op2, result); }
+	inline void lazy_sub_8(uint8_t op1, uint8_t op2, uint16_t result) { lazy_flags(LAZY_SUB_8, N_FLAG|Z_FLAG|V_FLAG|C_FLAG, op1, op2, result); }
+	inline void lazy_add_16(uint16_t op1, uint16_t op2, uint32_t result) { lazy_flags(LAZY_ADD_16, N_FLAG|Z_FLAG|V_FLAG|C_FLAG, op1, op2, result); }
+	inline void lazy_sub_16(uint16_t op1, uint16_t op2, uint32_t result) { lazy_flags(LAZY_SUB_16, N_FLAG|Z_FLAG|V_FLAG|C_FLAG, op1, op2, result); }
+
 	uint16_t *index_regs[4];
 
 	bool nmi_enabled;
 	bool default_pin;
+	bool default_attention;
 
 	bool *nmi_line;
 	bool old_nmi_line;
@@ -184,12 +363,149 @@ private:
 	bool old_firq_line;
 	bool *irq_line;
 	bool old_irq_line;
+	bool *attention_line;
+
+	/*
+	 * Starts the highest priority interrupt that is due, returns false
+	 * if there is none. Lines aren't looked at without attention.
+	 */
+	inline bool interrupt() {
+		if (*attention_line == false) {
+			return false;
+		} else if ((*nmi_line == false) && (old_nmi_line == true) && nmi_enabled) {
+			nmi();
+		} else if ((*firq_line == false) && is_f_flag_clear()) {
+			firq();
+		} else if ((*irq_line == false) && is_i_flag_clear()) {
+			irq();
+		} else {
+			return false;
+		}
+		return true;
+	}
 
 	int32_t cycle_saldo;
 	uint32_t cycles;
+	uint32_t run_end;
+
+	enum cpu_state {
+		STATE_NORMAL,
+		STATE_CWAI,	// entire state stacked, waiting for interrupt
+		STATE_SYNC	// waiting for any interrupt line, even if masked
+	} state;
+
+	/*
+	 * Checked when no interrupt is taken. Returns true if the cpu stays
+	 * halted, sync ends on any interrupt line going low.
+	 */
+	inline bool waiting() {
+		if ((state == STATE_SYNC) && *attention_line && !(*nmi_line && *firq_line && *irq_line))
+			state = STATE_NORMAL;
+		return state != STATE_NORMAL;
+	}
 
-	typedef uint16_t (mc6809::*addressing_mode)(bool *legal);
-	typedef void (mc6809::*execute_instruction)(uint16_t);
+	bool idle_loops;
+	uint64_t idle_cycles;
+	bool (*side_effect_free_read)(void *context, uint16_t address);
+	void *side_effect_free_context;
+
+	bus_t bus;
+	inline uint8_t read_8(uint16_t address) { return bus.read_8(address); }
+	inline void write_8(uint16_t address, uint8_t byte) { bus.write_8(address, byte); }
+
+	void init();
+
+	/*
+	 * Temporary variables used during individual instructions. d_reg
+	 * is a stand-in to ease calculations with the d register.
+	 */
+	uint8_t  byte;
+	uint16_t word;
+	uint32_t dword;
+	uint16_t d_reg;
+
+	typedef uint16_t (mc6809_t::*addressing_mode)(bool *legal);
+	typedef void (mc6809_t::*execute_instruction)(uint16_t);
+
+	struct predecoded_instruction {
+		execute_instruction handler;
+		addressing_mode mode;
+		uint32_t generation;	// valid if equal to predecode_generation
+		uint16_t index;		// page (0, 1 or 2) * 256 + opcode
+		uint8_t cycles;
+		uint8_t length;		// 1, or 2 for page 2/3 opcodes
+	};
+
+	predecoded_instruction *predecode_cache;
+	predecoded_instruction predecode_uncached;
+	uint32_t predecode_generation;
+	bool predecode_cacheable[256];
+	predecoded_instruction *predecode(uint16_t address);
+
+	/*
+	 * Translated blocks: straight runs of predecoded instructions that
+	 * end with the first instruction changing flow, cc or a stack. A
+	 * block is valid as long as its generation equals the predecode
+	 * generation.
+	 */
+	typedef int (*native_block)(mc6809_t *cpu);
+
+	struct translated_block {
+		uint32_t generation;
+		uint16_t start;
+		uint16_t end;		// first byte after the block
+		uint16_t guard;		// max cycles before last instruction starts
+		bool     idle;		// reads and branches back to its start only
+		bool     idle_direct;	// idle block reads direct page...
+		uint8_t  idle_dp;	// ...which must be this one
+		uint8_t  no_of_idle_io;
+		uint16_t idle_io[MC6809_IDLE_IO];	// i/o addresses read by idle block
+		uint8_t  no_of_instructions;
+		uint8_t  heat;		// entries, compiled when it reaches MC6809_JIT_HEAT
+		native_block native;	// returns no of instructions executed
+		predecoded_instruction instructions[MC6809_BLOCK_INSTRUCTIONS];
+	};
+
+	translated_block *blocks;
+	uint16_t blocks_used;
+	uint16_t *block_map;		// start address to block, 0 is none
+	uint8_t *block_heat;
+	bool *block_covered;
+	bool ends_block[768];
+	bool idle_instruction[768];	// reads and sets registers / flags only
+	bool branch_instruction[768];	// relative branch, no subroutine call
+	void init_blocks();
+	void translate_block(uint16_t address);
+	void invalidate_blocks(uint16_t address);
+	bool idle_read(uint16_t operand, predecoded_instruction *instruction, translated_block *block);
+	inline bool idle_io_free(translated_block *block) {
+		for (int i=0; i<block->no_of_idle_io; i++) {
+			if (!side_effect_free_read(side_effect_free_context, block->idle_io[i])) return false;
+		}
+		return true;
+	}
+	uint8_t operand_length(uint16_t address, predecoded_instruction *instruction);
+
+	/*
+	 * Native code. code_map marks bytes that predecoded instructions
+	 * or blocks depend on, so generated code only reports writes to
+	 * predecode_invalidate() when needed.
+	 */
+	bool jit;
+	uint8_t *jit_buffer;
+	uint32_t jit_used;
+	bool *code_map;
+	uint8_t *jit_read_page[256];
+	uint8_t *jit_write_page[256];
+	void init_jit();
+	void cleanup_jit();
+	void jit_flush();
+	void jit_compile(translated_block *block);
+	static uint8_t jit_read(mc6809_t *cpu, uint16_t address);
+	static void jit_write(mc6809_t *cpu, uint16_t address, uint8_t byte);
+	static void jit_invalidate(mc6809_t *cpu, uint16_t address);
+	static void jit_evaluate(mc6809_t *cpu);
+	static void jit_instruction(mc6809_t *cpu, predecoded_instruction *instruction);
 
 	bool disassemble_success;
 
@@ -198,6 +514,7 @@ private:
 	 * by the execute() function that polls the different interrupt lines
 	 * or detects an illegal opcode.
 	 */
+	void push_entire_state();
 	void nmi();
 	void firq();
 	void irq();
@@ -206,10 +523,10 @@ private:
 	/*
 	 * Internal stackpointer functionality
 	 */
-	inline void    push_sp(uint8_t byte) { (*write_8)(--sp, byte); }
-	inline uint8_t pull_sp()             { return (*read_8)(sp++); }
-	inline void    push_us(uint8_t byte) { (*write_8)(--us, byte); }
-	inline uint8_t pull_us()             { return (*read_8)(us++); }
+	inline void    push_sp(uint8_t byte) { write_8(--sp, byte); }
+	inline uint8_t pull_sp()             { return read_8(sp++); }
+	inline void    push_us(uint8_t byte) { write_8(--us, byte); }
+	inline uint8_t pull_us()             { return read_8(us++); }
 
 	/*
 	 * addressing modes
@@ -381,213 +698,213 @@ private:
 
 private:
 	const execute_instruction opcodes_page1[256] = {
-		&mc6809::neg,	&mc6809::ill,	&mc6809::ill,	&mc6809::com,	&mc6809::lsr,	&mc6809::ill,	&mc6809::ror,	&mc6809::asr,	// 0x00
-		&mc6809::asl,	&mc6809::rol,	&mc6809::dec,	&mc6809::ill,	&mc6809::inc,	&mc6809::tst,	&mc6809::jmp,	&mc6809::clr,
-		&mc6809::page2,	&mc6809::page3,	&mc6809::nop,	&mc6809::sync,	&mc6809::ill,	&mc6809::ill,	&mc6809::lbra,	&mc6809::lbsr,	// 0x10
-		&mc6809::ill,	&mc6809::daa,	&mc6809::orcc,	&mc6809::ill,	&mc6809::andcc,	&mc6809::sex,	&mc6809::exg,	&mc6809::tfr,
-		&mc6809::bra,	&mc6809::brn,	&mc6809::bhi,	&mc6809::bls,	&mc6809::bhs,	&mc6809::blo,	&mc6809::bne,	&mc6809::beq,	// 0x20
-		&mc6809::bvc,	&mc6809::bvs,	&mc6809::bpl,	&mc6809::bmi,	&mc6809::bge,	&mc6809::blt,	&mc6809::bgt,	&mc6809::ble,
-		&mc6809::leax,	&mc6809::leay,	&mc6809::leas,	&mc6809::leau,	&mc6809::pshs,	&mc6809::puls,	&mc6809::pshu,	&mc6809::pulu,	// 0x30
-		&mc6809::ill,	&mc6809::rts,	&mc6809::abx,	&mc6809::rti,	&mc6809::cwai,	&mc6809::mul,	&mc6809::ill,	&mc6809::swi,
-		&mc6809::nega,	&mc6809::ill,	&mc6809::ill,	&mc6809::coma,	&mc6809::lsra,	&mc6809::ill,	&mc6809::rora,	&mc6809::asra,	// 0x40
-		&mc6809::asla,	&mc6809::rola,	&mc6809::deca,	&mc6809::ill,	&mc6809::inca,	&mc6809::tsta,	&mc6809::ill,	&mc6809::clra,
-		&mc6809::negb,	&mc6809::ill,	&mc6809::ill,	&mc6809::comb,	&mc6809::lsrb,	&mc6809::ill,	&mc6809::rorb,	&mc6809::asrb,	// 0x50
-		&mc6809::aslb,	&mc6809::rolb,	&mc6809::decb,	&mc6809::ill,	&mc6809::incb,	&mc6809::tstb,	&mc6809::ill,	&mc6809::clrb,
-		&mc6809::neg,	&mc6809::ill,	&mc6809::ill,	&mc6809::com,	&mc6809::lsr,	&mc6809::ill,	&mc6809::ror,	&mc6809::asr,	// 0x60
-		&mc6809::asl,	&mc6809::rol,	&mc6809::dec,	&mc6809::ill,	&mc6809::inc,	&mc6809::tst,	&mc6809::jmp,	&mc6809::clr,
-		&mc6809::neg,	&mc6809::ill,	&mc6809::ill,	&mc6809::com,	&mc6809::lsr,	&mc6809::ill,	&mc6809::ror,	&mc6809::asr,	// 0x70
-		&mc6809::asl,	&mc6809::rol,	&mc6809::dec,	&mc6809::ill,	&mc6809::inc,	&mc6809::tst,	&mc6809::jmp,	&mc6809::clr,
-		&mc6809::suba,	&mc6809::cmpa,	&mc6809::sbca,	&mc6809::subd,	&mc6809::anda,	&mc6809::bita,	&mc6809::lda,	&mc6809::ill,	// 0x80
-		&mc6809::eora,	&mc6809::adca,	&mc6809::ora,	&mc6809::adda,	&mc6809::cmpx,	&mc6809::bsr,	&mc6809::ldx,	&mc6809::ill,
-		&mc6809::suba,	&mc6809::cmpa,	&mc6809::sbca,	&mc6809::subd,	&mc6809::anda,	&mc6809::bita,	&mc6809::lda,	&mc6809::sta,	// 0x90
-		&mc6809::eora,	&mc6809::adca,	&mc6809::ora,	&mc6809::adda,	&mc6809::cmpx,	&mc6809::jsr,	&mc6809::ldx,	&mc6809::stx,
-		&mc6809::suba,	&mc6809::cmpa,	&mc6809::sbca,	&mc6809::subd,	&mc6809::anda,	&mc6809::bita,	&mc6809::lda,	&mc6809::sta,	// 0xa0
-		&mc6809::eora,	&mc6809::adca,	&mc6809::ora,	&mc6809::adda,	&mc6809::cmpx,	&mc6809::jsr,	&mc6809::ldx,	&mc6809::stx,
-		&mc6809::suba,	&mc6809::cmpa,	&mc6809::sbca,	&mc6809::subd,	&mc6809::anda,	&mc6809::bita,	&mc6809::lda,	&mc6809::sta,	// 0xb0
-		&mc6809::eora,	&mc6809::adca,	&mc6809::ora,	&mc6809::adda,	&mc6809::cmpx,	&mc6809::jsr,	&mc6809::ldx,	&mc6809::stx,
-		&mc6809::subb,	&mc6809::cmpb,	&mc6809::sbcb,	&mc6809::addd,	&mc6809::andb,	&mc6809::bitb,	&mc6809::ldb,	&mc6809::ill,	// 0xc0
-		&mc6809::eorb,	&mc6809::adcb,	&mc6809::orb,	&mc6809::addb,	&mc6809::ldd,	&mc6809::ill,	&mc6809::ldu,	&mc6809::ill,
-		&mc6809::subb,	&mc6809::cmpb,	&mc6809::sbcb,	&mc6809::addd,	&mc6809::andb,	&mc6809::bitb,	&mc6809::ldb,	&mc6809::stb,	// 0xd0
-		&mc6809::eorb,	&mc6809::adcb,	&mc6809::orb,	&mc6809::addb,	&mc6809::ldd,	&mc6809::std,	&mc6809::ldu,	&mc6809::stu,
-		&mc6809::subb,	&mc6809::cmpb,	&mc6809::sbcb,	&mc6809::addd,	&mc6809::andb,	&mc6809::bitb,	&mc6809::ldb,	&mc6809::stb,	// 0xe0
-		&mc6809::eorb,	&mc6809::adcb,	&mc6809::orb,	&mc6809::addb,	&mc6809::ldd,	&mc6809::std,	&mc6809::ldu,	&mc6809::stu,
-		&mc6809::subb,	&mc6809::cmpb,	&mc6809::sbcb,	&mc6809::addd,	&mc6809::andb,	&mc6809::bitb,	&mc6809::ldb,	&mc6809::stb,	// 0xf0
-		&mc6809::eorb,	&mc6809::adcb,	&mc6809::orb,	&mc6809::addb,	&mc6809::ldd,	&mc6809::std,	&mc6809::ldu,	&mc6809::stu
+		&mc6809_t::neg,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::com,	&mc6809_t::lsr,	&mc6809_t::ill,	&mc6809_t::ror,	&mc6809_t::asr,	// 0x00
+		&mc6809_t::asl,	&mc6809_t::rol,	&mc6809_t::dec,	&mc6809_t::ill,	&mc6809_t::inc,	&mc6809_t::tst,	&mc6809_t::jmp,	&mc6809_t::clr,
+		&mc6809_t::page2,	&mc6809_t::page3,	&mc6809_t::nop,	&mc6809_t::sync,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::lbra,	&mc6809_t::lbsr,	// 0x10
+		&mc6809_t::ill,	&mc6809_t::daa,	&mc6809_t::orcc,	&mc6809_t::ill,	&mc6809_t::andcc,	&mc6809_t::sex,	&mc6809_t::exg,	&mc6809_t::tfr,
+		&mc6809_t::bra,	&mc6809_t::brn,	&mc6809_t::bhi,	&mc6809_t::bls,	&mc6809_t::bhs,	&mc6809_t::blo,	&mc6809_t::bne,	&mc6809_t::beq,	// 0x20
+		&mc6809_t::bvc,	&mc6809_t::bvs,	&mc6809_t::bpl,	&mc6809_t::bmi,	&mc6809_t::bge,	&mc6809_t::blt,	&mc6809_t::bgt,	&mc6809_t::ble,
+		&mc6809_t::leax,	&mc6809_t::leay,	&mc6809_t::leas,	&mc6809_t::leau,	&mc6809_t::pshs,	&mc6809_t::puls,	&mc6809_t::pshu,	&mc6809_t::pulu,	// 0x30
+		&mc6809_t::ill,	&mc6809_t::rts,	&mc6809_t::abx,	&mc6809_t::rti,	&mc6809_t::cwai,	&mc6809_t::mul,	&mc6809_t::ill,	&mc6809_t::swi,
+		&mc6809_t::nega,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::coma,	&mc6809_t::lsra,	&mc6809_t::ill,	&mc6809_t::rora,	&mc6809_t::asra,	// 0x40
+		&mc6809_t::asla,	&mc6809_t::rola,	&mc6809_t::deca,	&mc6809_t::ill,	&mc6809_t::inca,	&mc6809_t::tsta,	&mc6809_t::ill,	&mc6809_t::clra,
+		&mc6809_t::negb,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::comb,	&mc6809_t::lsrb,	&mc6809_t::ill,	&mc6809_t::rorb,	&mc6809_t::asrb,	// 0x50
+		&mc6809_t::aslb,	&mc6809_t::rolb,	&mc6809_t::decb,	&mc6809_t::ill,	&mc6809_t::incb,	&mc6809_t::tstb,	&mc6809_t::ill,	&mc6809_t::clrb,
+		&mc6809_t::neg,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::com,	&mc6809_t::lsr,	&mc6809_t::ill,	&mc6809_t::ror,	&mc6809_t::asr,	// 0x60
+		&mc6809_t::asl,	&mc6809_t::rol,	&mc6809_t::dec,	&mc6809_t::ill,	&mc6809_t::inc,	&mc6809_t::tst,	&mc6809_t::jmp,	&mc6809_t::clr,
+		&mc6809_t::neg,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::com,	&mc6809_t::lsr,	&mc6809_t::ill,	&mc6809_t::ror,	&mc6809_t::asr,	// 0x70
+		&mc6809_t::asl,	&mc6809_t::rol,	&mc6809_t::dec,	&mc6809_t::ill,	&mc6809_t::inc,	&mc6809_t::tst,	&mc6809_t::jmp,	&mc6809_t::clr,
+		&mc6809_t::suba,	&mc6809_t::cmpa,	&mc6809_t::sbca,	&mc6809_t::subd,	&mc6809_t::anda,	&mc6809_t::bita,	&mc6809_t::lda,	&mc6809_t::ill,	// 0x80
+		&mc6809_t::eora,	&mc6809_t::adca,	&mc6809_t::ora,	&mc6809_t::adda,	&mc6809_t::cmpx,	&mc6809_t::bsr,	&mc6809_t::ldx,	&mc6809_t::ill,
+		&mc6809_t::suba,	&mc6809_t::cmpa,	&mc6809_t::sbca,	&mc6809_t::subd,	&mc6809_t::anda,	&mc6809_t::bita,	&mc6809_t::lda,	&mc6809_t::sta,	// 0x90
+		&mc6809_t::eora,	&mc6809_t::adca,	&mc6809_t::ora,	&mc6809_t::adda,	&mc6809_t::cmpx,	&mc6809_t::jsr,	&mc6809_t::ldx,	&mc6809_t::stx,
+		&mc6809_t::suba,	&mc6809_t::cmpa,	&mc6809_t::sbca,	&mc6809_t::subd,	&mc6809_t::anda,	&mc6809_t::bita,	&mc6809_t::lda,	&mc6809_t::sta,	// 0xa0
+		&mc6809_t::eora,	&mc6809_t::adca,	&mc6809_t::ora,	&mc6809_t::adda,	&mc6809_t::cmpx,	&mc6809_t::jsr,	&mc6809_t::ldx,	&mc6809_t::stx,
+		&mc6809_t::suba,	&mc6809_t::cmpa,	&mc6809_t::sbca,	&mc6809_t::subd,	&mc6809_t::anda,	&mc6809_t::bita,	&mc6809_t::lda,	&mc6809_t::sta,	// 0xb0
+		&mc6809_t::eora,	&mc6809_t::adca,	&mc6809_t::ora,	&mc6809_t::adda,	&mc6809_t::cmpx,	&mc6809_t::jsr,	&mc6809_t::ldx,	&mc6809_t::stx,
+		&mc6809_t::subb,	&mc6809_t::cmpb,	&mc6809_t::sbcb,	&mc6809_t::addd,	&mc6809_t::andb,	&mc6809_t::bitb,	&mc6809_t::ldb,	&mc6809_t::ill,	// 0xc0
+		&mc6809_t::eorb,	&mc6809_t::adcb,	&mc6809_t::orb,	&mc6809_t::addb,	&mc6809_t::ldd,	&mc6809_t::ill,	&mc6809_t::ldu,	&mc6809_t::ill,
+		&mc6809_t::subb,	&mc6809_t::cmpb,	&mc6809_t::sbcb,	&mc6809_t::addd,	&mc6809_t::andb,	&mc6809_t::bitb,	&mc6809_t::ldb,	&mc6809_t::stb,	// 0xd0
+		&mc6809_t::eorb,	&mc6809_t::adcb,	&mc6809_t::orb,	&mc6809_t::addb,	&mc6809_t::ldd,	&mc6809_t::std,	&mc6809_t::ldu,	&mc6809_t::stu,
+		&mc6809_t::subb,	&mc6809_t::cmpb,	&mc6809_t::sbcb,	&mc6809_t::addd,	&mc6809_t::andb,	&mc6809_t::bitb,	&mc6809_t::ldb,	&mc6809_t::stb,	// 0xe0
+		&mc6809_t::eorb,	&mc6809_t::adcb,	&mc6809_t::orb,	&mc6809_t::addb,	&mc6809_t::ldd,	&mc6809_t::std,	&mc6809_t::ldu,	&mc6809_t::stu,
+		&mc6809_t::subb,	&mc6809_t::cmpb,	&mc6809_t::sbcb,	&mc6809_t::addd,	&mc6809_t::andb,	&mc6809_t::bitb,	&mc6809_t::ldb,	&mc6809_t::stb,	// 0xf0
+		&mc6809_t::eorb,	&mc6809_t::adcb,	&mc6809_t::orb,	&mc6809_t::addb,	&mc6809_t::ldd,	&mc6809_t::std,	&mc6809_t::ldu,	&mc6809_t::stu
 	};
 
 	const execute_instruction opcodes_page2[256] = {
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x00
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x10
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::lbrn,	&mc6809::lbhi,	&mc6809::lbls,	&mc6809::lbhs,	&mc6809::lblo,	&mc6809::lbne,	&mc6809::lbeq,	// 0x20
-		&mc6809::lbvc,	&mc6809::lbvs,	&mc6809::lbpl,	&mc6809::lbmi,	&mc6809::lbge,	&mc6809::lblt,	&mc6809::lbgt,	&mc6809::lble,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x30
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::swi2,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x40
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x50
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x60
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x70
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpd,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x80
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpy,	&mc6809::ill,	&mc6809::ldy,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpd,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x90
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpy,	&mc6809::ill,	&mc6809::ldy,	&mc6809::sty,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpd,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xa0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpy,	&mc6809::ill,	&mc6809::ldy,	&mc6809::sty,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpd,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xb0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpy,	&mc6809::ill,	&mc6809::ldy,	&mc6809::sty,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xc0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::lds,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xd0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::lds,	&mc6809::sts,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xe0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::lds,	&mc6809::sts,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xf0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::lds,	&mc6809::sts
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x00
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x10
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::lbrn,	&mc6809_t::lbhi,	&mc6809_t::lbls,	&mc6809_t::lbhs,	&mc6809_t::lblo,	&mc6809_t::lbne,	&mc6809_t::lbeq,	// 0x20
+		&mc6809_t::lbvc,	&mc6809_t::lbvs,	&mc6809_t::lbpl,	&mc6809_t::lbmi,	&mc6809_t::lbge,	&mc6809_t::lblt,	&mc6809_t::lbgt,	&mc6809_t::lble,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x30
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::swi2,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x40
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x50
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x60
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x70
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpd,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x80
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpy,	&mc6809_t::ill,	&mc6809_t::ldy,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpd,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x90
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpy,	&mc6809_t::ill,	&mc6809_t::ldy,	&mc6809_t::sty,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpd,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xa0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpy,	&mc6809_t::ill,	&mc6809_t::ldy,	&mc6809_t::sty,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpd,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xb0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpy,	&mc6809_t::ill,	&mc6809_t::ldy,	&mc6809_t::sty,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xc0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::lds,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xd0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::lds,	&mc6809_t::sts,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xe0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::lds,	&mc6809_t::sts,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xf0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::lds,	&mc6809_t::sts
 	};
 
 	const execute_instruction opcodes_page3[256] = {
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x00
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x10
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x20
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x30
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::swi3,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x40
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x50
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x60
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x70
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpu,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x80
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmps,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpu,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0x90
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmps,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpu,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xa0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmps,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmpu,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xb0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::cmps,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xc0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xd0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xe0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	// 0xf0
-		&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill,	&mc6809::ill
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x00
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x10
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x20
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x30
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::swi3,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x40
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x50
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x60
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x70
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpu,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x80
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmps,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpu,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0x90
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmps,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpu,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xa0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmps,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmpu,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xb0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::cmps,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xc0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xd0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xe0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	// 0xf0
+		&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill,	&mc6809_t::ill
 	};
 
 	const addressing_mode addressing_modes_page1[256] = {
-		&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,	// 0x00
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_rew,	&mc6809::a_rew,	// 0x10
-		&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_imb,	&mc6809::a_no,	&mc6809::a_imb,	&mc6809::a_ih,	&mc6809::a_imb,	&mc6809::a_imb,
-		&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	// 0x20
-		&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,	&mc6809::a_reb,
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	// 0x30
-		&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	// 0x40
-		&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	// 0x50
-		&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,	&mc6809::a_ih,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,	// 0x60
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext,	// 0x70
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,
-		&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_no,	// 0x80
-		&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_reb,	&mc6809::a_imw,	&mc6809::a_no,
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	// 0x90
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	// 0xa0
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	// 0xb0
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,
-		&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_no,	// 0xc0
-		&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imb,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	// 0xd0
-		&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	// 0xe0
-		&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	// 0xf0
-		&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext,	&mc6809::a_ext
+		&mc6809_t::a_dir,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	// 0x00
+		&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,
+		&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	// 0x10
+		&mc6809_t::a_no,	&mc6809_t::a_ih,	&mc6809_t::a_imb,	&mc6809_t::a_no,	&mc6809_t::a_imb,	&mc6809_t::a_ih,	&mc6809_t::a_imb,	&mc6809_t::a_imb,
+		&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	// 0x20
+		&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,	&mc6809_t::a_reb,
+		&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	// 0x30
+		&mc6809_t::a_no,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_imb,	&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_ih,
+		&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	// 0x40
+		&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_ih,
+		&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	// 0x50
+		&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_ih,	&mc6809_t::a_ih,	&mc6809_t::a_no,	&mc6809_t::a_ih,
+		&mc6809_t::a_idx,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	// 0x60
+		&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,
+		&mc6809_t::a_ext,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	// 0x70
+		&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,
+		&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imw,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_no,	// 0x80
+		&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imw,	&mc6809_t::a_reb,	&mc6809_t::a_imw,	&mc6809_t::a_no,
+		&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	// 0x90
+		&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,
+		&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	// 0xa0
+		&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,
+		&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	// 0xb0
+		&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,
+		&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imw,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_no,	// 0xc0
+		&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imb,	&mc6809_t::a_imw,	&mc6809_t::a_no,	&mc6809_t::a_imw,	&mc6809_t::a_no,
+		&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	// 0xd0
+		&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,	&mc6809_t::a_dir,
+		&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	// 0xe0
+		&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,	&mc6809_t::a_idx,
+		&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	// 0xf0
+		&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext,	&mc6809_t::a_ext
 	};
 
 	const addressing_mode addressing_modes_page2[256] = {
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x00
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x10
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	// 0x20
-		&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,	&mc6809::a_rew,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x30
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x40
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x50
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x60
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x70
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x80
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x90
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xa0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xb0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xc0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xd0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_dir,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xe0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_idx,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xf0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_ext
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x00
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x10
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	// 0x20
+		&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,	&mc6809_t::a_rew,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x30
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ih,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x40
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x50
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x60
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x70
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_imw,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x80
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_imw,	&mc6809_t::a_no,	&mc6809_t::a_imw,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x90
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_dir,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xa0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_idx,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xb0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_ext,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xc0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_imw,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xd0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_dir,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xe0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_idx,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xf0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_ext
 	};
 
 	const addressing_mode addressing_modes_page3[256] = {
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x00
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x10
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x20
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x30
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ih,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x40
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x50
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x60
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x70
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x80
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_imw,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0x90
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_dir,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xa0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_idx,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xb0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_ext,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xc0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xd0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xe0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	// 0xf0
-		&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no,	&mc6809::a_no
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x00
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x10
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x20
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x30
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ih,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x40
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x50
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x60
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x70
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_imw,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x80
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_imw,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0x90
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_dir,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xa0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_idx,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xb0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_ext,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xc0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xd0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xe0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	// 0xf0
+		&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no,	&mc6809_t::a_no
 	};
 
 	const uint16_t cycles_page1[256] = {
@@ -648,4 +965,13 @@ private:
 	};
 };
 
+typedef mc6809_t<mc6809_callback_bus> mc6809;
+
+/*
+ * Member functions are defined in mc6809_cpp.hpp. Embedders with their
+ * own bus policy include that file in one translation unit and
+ * explicitly instantiate mc6809_t<policy> there (see mc6809.cpp).
+ */
+extern template class mc6809_t<mc6809_callback_bus>;
+
 #endif
@@ -1,31 +1,35 @@
 /*
- * mc6809_addressing_modes.cpp  -  part of MC6809
+ * mc6809_addressing_modes_cpp.hpp  -  part of MC6809
  *
  * (C)2021-2022 elmerucr
  */
 
 #include "mc6809.hpp"
 
-uint16_t mc6809::a_dir(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_dir(bool *legal)
 {
 	*legal = true;
-	return (dp << 8) | (*read_8)(pc++);
+	return (dp << 8) | read_8(pc++);
 }
 
-uint16_t mc6809::a_ih(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_ih(bool *legal)
 {
 	// Inherent, instruction contains all information.
 	*legal = true;
 	return 0;
 }
 
-uint16_t mc6809::a_imb(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_imb(bool *legal)
 {
 	*legal = true;
 	return pc++;
 }
 
-uint16_t mc6809::a_imw(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_imw(bool *legal)
 {
 	uint16_t address = pc++;
 	pc++;
@@ -33,23 +37,26 @@ uint16_t mc6809::a_imw(bool *legal)
 	return address;
 }
 
-uint16_t mc6809::a_reb(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_reb(bool *legal)
 {
 	// sign extend the 8 bit value
-	uint16_t offset = (uint16_t)((int8_t)(*read_8)(pc++));
+	uint16_t offset = (uint16_t)((int8_t)read_8(pc++));
 	*legal = true;
 	return (uint16_t)(pc + offset);
 }
 
-uint16_t mc6809::a_rew(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_rew(bool *legal)
 {
-	uint16_t offset = (*read_8)(pc++);
-	offset = (offset << 8) | (*read_8)(pc++);
+	uint16_t offset = read_8(pc++);
+	offset = (offset << 8) | read_8(pc++);
 	*legal = true;
 	return pc + offset;
 }
 
-uint16_t mc6809::a_idx(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_idx(bool *legal)
 {
 	/*
 	 * First, assume the addressing mode is legal. If not, this
@@ -63,7 +70,7 @@ uint16_t mc6809::a_idx(bool *legal)
 	uint16_t word;
 
 	// read postbyte
-	uint8_t postbyte = (*read_8)(pc++);
+	uint8_t postbyte = read_8(pc++);
 
 	if (postbyte == 0b10011111) {
 		/*
@@ -71,10 +78,10 @@ uint16_t mc6809::a_idx(bool *legal)
 		 */
 		cycles += 5;
 
-		word = (*read_8)(pc++) << 8;
-		word |= (*read_8)(pc++);
-		address = (*read_8)(word++) << 8;
-		address |= (*read_8)(word);
+		word = read_8(pc++) << 8;
+		word |= read_8(pc++);
+		address = read_8(word++) << 8;
+		address |= read_8(word);
 	} else {
 		switch (postbyte & 0b10000000) {
 		case 0b00000000:
@@ -117,7 +124,7 @@ uint16_t mc6809::a_idx(bool *legal)
 					 */
 					cycles += 1;
 
-					byte = (*read_8)(pc++);
+					byte = read_8(pc++);
 					if (byte & 0b10000000) {
 						offset = 0xff00 | byte;
 					} else {
@@ -132,8 +139,8 @@ uint16_t mc6809::a_idx(bool *legal)
 					 */
 					cycles += 4;
 
-					offset = (*read_8)(pc++) << 8;
-					offset |= (*read_8)(pc++);
+					offset = read_8(pc++) << 8;
+					offset |= read_8(pc++);
 					address = *index_regs[(postbyte & 0b01100000) >> 5]
 						+ offset;
 					break;
@@ -217,7 +224,7 @@ uint16_t mc6809::a_idx(bool *legal)
 					 */
 					cycles += 1;
 
-					byte = (*read_8)(pc++);
+					byte = read_8(pc++);
 					if (byte & 0b10000000) {
 						offset = 0xff00 | byte;
 					} else {
@@ -231,8 +238,8 @@ uint16_t mc6809::a_idx(bool *legal)
 					 */
 					cycles += 5;
 
-					offset = (*read_8)(pc++) << 8;
-					offset |= (*read_8)(pc++);
+					offset = read_8(pc++) << 8;
+					offset |= read_8(pc++);
 					address = pc + offset;
 					break;
 				default:
@@ -255,8 +262,8 @@ uint16_t mc6809::a_idx(bool *legal)
 					cycles += 3;
 
 					word = *index_regs[(postbyte & 0b01100000) >> 5];
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b1000:
 					/*
@@ -264,7 +271,7 @@ uint16_t mc6809::a_idx(bool *legal)
 					 */
 					cycles += 4;
 
-					byte = (*read_8)(pc++);
+					byte = read_8(pc++);
 					if (byte & 0b10000000) {
 						offset = 0xff00 | byte;
 					} else {
@@ -272,8 +279,8 @@ uint16_t mc6809::a_idx(bool *legal)
 					}
 					word = *index_regs[(postbyte & 0b01100000) >> 5]
 						+ offset;
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b1001:
 					/*
@@ -281,12 +288,12 @@ uint16_t mc6809::a_idx(bool *legal)
 					 */
 					cycles += 7;
 
-					offset = (*read_8)(pc++) << 8;
-					offset |= (*read_8)(pc++);
+					offset = read_8(pc++) << 8;
+					offset |= read_8(pc++);
 					word = *index_regs[(postbyte & 0b01100000) >> 5]
 						+ offset;
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b0110:
 					/*
@@ -301,8 +308,8 @@ uint16_t mc6809::a_idx(bool *legal)
 					}
 					word = *index_regs[(postbyte & 0b01100000) >> 5]
 						+ offset;
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b0101:
 					/*
@@ -317,8 +324,8 @@ uint16_t mc6809::a_idx(bool *legal)
 					}
 					word = *index_regs[(postbyte & 0b01100000) >> 5]
 						+ offset;
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b1011:
 					/*
@@ -329,8 +336,8 @@ uint16_t mc6809::a_idx(bool *legal)
 					offset = (ac << 8) | br;
 					word = *index_regs[(postbyte & 0b01100000) >> 5]
 						+ offset;
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b0001:
 					/*
@@ -340,8 +347,8 @@ uint16_t mc6809::a_idx(bool *legal)
 
 					word = *index_regs[(postbyte & 0b01100000) >> 5];
 					(*index_regs[(postbyte & 0b01100000) >> 5]) += 2;
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b0011:
 					/*
@@ -351,8 +358,8 @@ uint16_t mc6809::a_idx(bool *legal)
 
 					(*index_regs[(postbyte & 0b01100000) >> 5]) -= 2;
 					word = *index_regs[(postbyte & 0b01100000) >> 5];
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b1100:
 					/*
@@ -360,15 +367,15 @@ uint16_t mc6809::a_idx(bool *legal)
 					 */
 					cycles += 4;
 
-					byte = (*read_8)(pc++);
+					byte = read_8(pc++);
 					if (byte & 0b10000000) {
 						offset = 0xff00 | byte;
 					} else {
 						offset = byte;
 					}
 					word = pc + offset;
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				case 0b1101:
 					/*
@@ -376,11 +383,11 @@ uint16_t mc6809::a_idx(bool *legal)
 					 */
 					cycles += 8;
 
-					offset = (*read_8)(pc++) << 8;
-					offset |= (*read_8)(pc++);
+					offset = read_8(pc++) << 8;
+					offset |= read_8(pc++);
 					word = pc + offset;
-					address = (*read_8)(word++) << 8;
-					address |= (*read_8)(word);
+					address = read_8(word++) << 8;
+					address |= read_8(word);
 					break;
 				default:
 					// TODO
@@ -396,15 +403,17 @@ uint16_t mc6809::a_idx(bool *legal)
 	return address;
 }
 
-uint16_t mc6809::a_ext(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_ext(bool *legal)
 {
-	uint16_t word = ((*read_8)(pc++)) << 8;
-	word |= (*read_8)(pc++);
+	uint16_t word = (read_8(pc++)) << 8;
+	word |= read_8(pc++);
 	*legal = true;
 	return word;
 }
 
-uint16_t mc6809::a_no(bool *legal)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::a_no(bool *legal)
 {
 	// no mode @ illegal instruction
 	*legal = false;
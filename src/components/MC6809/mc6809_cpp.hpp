@@ -0,0 +1,418 @@
+/*
+ * mc6809_cpp.hpp  -  part of MC6809
+ *
+ * (C)2021-2022 elmerucr
+ */
+
+/*
+ * Template definitions of the cpu, together with the files included at
+ * the bottom. Include in exactly one translation unit per bus policy.
+ */
+
+#include "mc6809.hpp"
+#include <cstdio>
+
+template <class bus_t>
+void mc6809_t<bus_t>::init()
+{
+	cc = 0b00000000;
+	lazy_mask = 0;
+
+	/*
+	 * When NFI pins are not (yet) assigned, there needs to be a
+	 * decent starting value (true).
+	 */
+	default_pin = true;
+	nmi_line = &default_pin;
+	firq_line = &default_pin;
+	irq_line = &default_pin;
+	default_attention = true;
+	attention_line = &default_attention;
+
+	cycles = 0;
+	run_end = 0;
+
+	state = STATE_NORMAL;
+	idle_loops = false;
+	idle_cycles = 0;
+	side_effect_free_read = nullptr;
+	side_effect_free_context = nullptr;
+
+	index_regs[0b00] = &xr;
+	index_regs[0b01] = &yr;
+	index_regs[0b10] = &us;
+	index_regs[0b11] = &sp;
+
+	predecode_cache = new predecoded_instruction[65536];
+	for (int i=0; i<65536; i++) predecode_cache[i].generation = 0;
+	for (int i=0; i<256; i++) predecode_cacheable[i] = true;
+	predecode_generation = 1;
+	init_blocks();
+	init_jit();
+
+	breakpoint_array = NULL;
+	breakpoint_array = new bool[65536];
+	clear_breakpoints();
+	
+	printf("[MC6809] version %i.%i.%i (C)%i elmerucr\n",
+	       MC6809_MAJOR_VERSION,
+	       MC6809_MINOR_VERSION,
+	       MC6809_BUILD,
+	       MC6809_YEAR);
+}
+
+template <class bus_t>
+mc6809_t<bus_t>::~mc6809_t()
+{
+	printf("[MC6809] cleaning up\n");
+	cleanup_jit();
+	delete [] block_covered;
+	delete [] block_heat;
+	delete [] block_map;
+	delete [] blocks;
+	delete [] predecode_cache;
+	delete breakpoint_array;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::reset()
+{
+	printf("[MC6809] resetting cpu\n");
+	/*
+	 * For 6800 compatibility, direct page register defaults to
+	 * zero after a reset.
+	 */
+	dp = 0x00;
+
+	/*
+	 * firq and irq masked after reset
+	 */
+	cc |= (I_FLAG | F_FLAG);
+
+	/*
+	 * After reset, nmi is fully disabled. Only after a first write
+	 * to the system stackpointer enabled.
+	 */
+	nmi_enabled = false;
+	old_nmi_line = *nmi_line;
+
+	state = STATE_NORMAL;
+
+	predecode_flush();
+
+	/*
+	 * Load program counter from vector
+	 */
+	pc = 0;
+	pc = (read_8(VECTOR_RESET)) << 8;
+	pc |= read_8(VECTOR_RESET+1);
+}
+
+template <class bus_t>
+uint8_t mc6809_t<bus_t>::execute()
+{
+	uint32_t old_cycles = cycles;
+	
+	if (!interrupt()) {
+		if (waiting()) {
+			cycles += 1;
+		} else {
+			predecoded_instruction *instruction = &predecode_cache[pc];
+			if (instruction->generation != predecode_generation) {
+				instruction = predecode(pc);
+			}
+			/*
+			 * TODO: check for illegal opcode and start exception
+			 */
+			pc += instruction->length;
+			cycles += instruction->cycles;
+			bool am_legal;
+			uint16_t effective_address = (this->*instruction->mode)(&am_legal);
+			(this->*instruction->handler)(effective_address);
+		}
+	}
+	
+	old_nmi_line = !*attention_line || *nmi_line;
+	return cycles - old_cycles;
+}
+
+template <class bus_t>
+typename mc6809_t<bus_t>::predecoded_instruction *mc6809_t<bus_t>::predecode(uint16_t address)
+{
+	predecoded_instruction *instruction = &predecode_cache[address];
+	bool cacheable = predecode_cacheable[address >> 8];
+
+	uint8_t opcode = read_8(address);
+
+	if (opcode == 0x10 || opcode == 0x11) {
+		uint16_t next = address + 1;
+		cacheable = cacheable && predecode_cacheable[next >> 8];
+		if (!cacheable) instruction = &predecode_uncached;
+
+		uint8_t opcode_2 = read_8(next);
+		if (opcode == 0x10) {
+			instruction->handler = opcodes_page2[opcode_2];
+			instruction->mode = addressing_modes_page2[opcode_2];
+			instruction->cycles = cycles_page2[opcode_2];
+			instruction->index = 0x100 | opcode_2;
+		} else {
+			instruction->handler = opcodes_page3[opcode_2];
+			instruction->mode = addressing_modes_page3[opcode_2];
+			instruction->cycles = cycles_page3[opcode_2];
+			instruction->index = 0x200 | opcode_2;
+		}
+		instruction->length = 2;
+	} else {
+		if (!cacheable) instruction = &predecode_uncached;
+
+		instruction->handler = opcodes_page1[opcode];
+		instruction->mode = addressing_modes_page1[opcode];
+		instruction->cycles = cycles_page1[opcode];
+		instruction->index = opcode;
+		instruction->length = 1;
+	}
+
+	instruction->generation = cacheable ? predecode_generation : 0;
+	if (cacheable) {
+		code_map[address] = true;
+		code_map[(uint16_t)(address + 1)] = true;
+	}
+	return instruction;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::predecode_flush()
+{
+	/*
+	 * Generation 0 is never valid. Only on wraparound the entries
+	 * themselves need to be touched.
+	 */
+	if (++predecode_generation == 0) {
+		for (int i=0; i<65536; i++) predecode_cache[i].generation = 0;
+		predecode_generation = 1;
+	}
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::predecode_set_cacheable(uint8_t page, bool cacheable)
+{
+	if (predecode_cacheable[page] != cacheable) {
+		predecode_cacheable[page] = cacheable;
+		predecode_flush();
+	}
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::toggle_breakpoint(uint16_t address)
+{
+	breakpoint_array[address] = !breakpoint_array[address];
+
+	// translated blocks must end in front of breakpoints
+	predecode_flush();
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::clear_breakpoints()
+{
+	for (int i=0; i<65536; i++) {
+		breakpoint_array[i] = false;
+	}
+	predecode_flush();
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::evaluate_flags()
+{
+	uint8_t flags = 0;
+
+	switch (lazy_kind) {
+		case LAZY_LOGIC_8:
+			if (lazy_result & 0x80) flags |= N_FLAG;
+			if (!(lazy_result & 0xff)) flags |= Z_FLAG;
+			break;
+		case LAZY_LOGIC_16:
+			if (lazy_result & 0x8000) flags |= N_FLAG;
+			if (!(lazy_result & 0xffff)) flags |= Z_FLAG;
+			break;
+		case LAZY_ADD_8:
+			if ((lazy_op1 ^ lazy_op2 ^ lazy_result) & 0x10) flags |= H_FLAG;
+			if (lazy_result & 0x80) flags |= N_FLAG;
+			if (!(lazy_result & 0xff)) flags |= Z_FLAG;
+			if ((lazy_op1 ^ lazy_result) & (lazy_op2 ^ lazy_result) & 0x80) flags |= V_FLAG;
+			if (lazy_result & 0x100) flags |= C_FLAG;
+			break;
+		case LAZY_SUB_8:
+			if (lazy_result & 0x80) flags |= N_FLAG;
+			if (!(lazy_result & 0xff)) flags |= Z_FLAG;
+			if ((lazy_op1 ^ lazy_result) & (lazy_op1 ^ lazy_op2) & 0x80) flags |= V_FLAG;
+			if (lazy_result > 0xff) flags |= C_FLAG;
+			break;
+		case LAZY_ADD_16:
+			if (lazy_result & 0x8000) flags |= N_FLAG;
+			if (!(lazy_result & 0xffff)) flags |= Z_FLAG;
+			if ((lazy_op1 ^ lazy_result) & (lazy_op2 ^ lazy_result) & 0x8000) flags |= V_FLAG;
+			if (lazy_result & 0x10000) flags |= C_FLAG;
+			break;
+		case LAZY_SUB_16:
+			if (lazy_result & 0x8000) flags |= N_FLAG;
+			if (!(lazy_result & 0xffff)) flags |= Z_FLAG;
+			if ((lazy_op1 ^ lazy_result) & (lazy_op1 ^ lazy_op2) & 0x8000) flags |= V_FLAG;
+			if (lazy_result > 0xffff) flags |= C_FLAG;
+			break;
+	}
+
+	cc = (cc & ~lazy_mask) | (flags & lazy_mask);
+	lazy_mask = 0;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::push_entire_state()
+{
+	push_sp(pc & 0x00ff);
+	push_sp((pc & 0xff00) >> 8);
+	push_sp(us & 0x00ff);
+	push_sp((us & 0xff00) >> 8);
+	push_sp(yr & 0x00ff);
+	push_sp((yr & 0xff00) >> 8);
+	push_sp(xr & 0x00ff);
+	push_sp((xr & 0xff00) >> 8);
+	push_sp(dp);
+	push_sp(br);
+	push_sp(ac);
+	set_e_flag();
+	materialize_flags();
+	push_sp(cc);
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::nmi()
+{
+	// after cwai, the entire state is on the stack already
+	if (state != STATE_CWAI) push_entire_state();
+	state = STATE_NORMAL;
+	set_i_flag();
+	set_f_flag();
+	pc = 0;
+	pc = (read_8(VECTOR_NMI)) << 8;
+	pc |= read_8(VECTOR_NMI+1);
+
+	/*
+	 * can't find this in the documentation
+	 */
+	cycles += 19;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::firq()
+{
+	/*
+	 * After cwai, the entire state is on the stack with the e flag
+	 * set, rti will restore all of it.
+	 */
+	if (state != STATE_CWAI) {
+		push_sp(pc & 0x00ff);
+		push_sp((pc & 0xff00) >> 8);
+		clear_e_flag();
+		materialize_flags();
+		push_sp(cc);
+	}
+	state = STATE_NORMAL;
+	set_f_flag();
+	set_i_flag();
+	pc = 0;
+	pc = (read_8(VECTOR_FIRQ)) << 8;
+	pc |= read_8(VECTOR_FIRQ+1);
+
+	/*
+	 * can't find this in the documentation
+	 */
+	cycles += 10;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::irq()
+{
+	if (state != STATE_CWAI) push_entire_state();
+	state = STATE_NORMAL;
+	set_i_flag();
+	pc = 0;
+	pc = (read_8(VECTOR_IRQ)) << 8;
+	pc |= read_8(VECTOR_IRQ+1);
+
+	/*
+	 * can't find this in the documentation
+	 */
+	cycles += 19;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::illegal_opcode()
+{
+	push_entire_state();
+	set_i_flag();
+	set_f_flag();
+	pc = 0;
+	pc = (read_8(VECTOR_ILL_OPC)) << 8;
+	pc |= read_8(VECTOR_ILL_OPC+1);
+
+	/*
+	 * same as nmi number of cycles
+	 */
+	cycles += 19;
+}
+
+/*
+ *  pc  dp ac br  xr   yr   us   sp  efhinzvc  N F I  NMI enabled/blocked
+ * c000 00 01:ae 0000 d0d0 0000 0ffc -*-*---- 11 1 1  state normal/cwai/sync
+ */
+template <class bus_t>
+void mc6809_t<bus_t>::status(char *text_buffer)
+{
+	materialize_flags();
+
+	sprintf(text_buffer, " pc  dp ac br  xr   yr   us   sp  efhinzvc  N F I  NMI %s\n"
+			"%04x %02x %02x:%02x "
+			"%04x %04x %04x %04x "
+			"%c%c%c%c%c%c%c%c "
+			"%c%c %c %c  "
+			"state %s",
+			nmi_enabled ? "enabled" : "blocked",
+			pc, dp, ac, br,
+			xr, yr, us, sp,
+			cc & E_FLAG ? '*' : '-',
+			cc & F_FLAG ? '*' : '-',
+			cc & H_FLAG ? '*' : '-',
+			cc & I_FLAG ? '*' : '-',
+			cc & N_FLAG ? '*' : '-',
+			cc & Z_FLAG ? '*' : '-',
+			cc & V_FLAG ? '*' : '-',
+			cc & C_FLAG ? '*' : '-',
+			old_nmi_line ? '1' : '0',
+			*nmi_line ? '1' : '0',
+			*firq_line ? '1' : '0',
+			*irq_line ? '1' : '0',
+			state == STATE_CWAI ? "cwai" : (state == STATE_SYNC ? "sync" : "normal"));
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::stacks(char *text_buffer, int no)
+{
+	// display top of both stacks as 8 and 16 bit values
+	text_buffer += sprintf(text_buffer, "  usp      ssp\n");
+	for (int i=0; i<no; i++) {
+		text_buffer += sprintf(text_buffer, "%04x %02x  %04x %02x",
+			get_us() + i,
+			read_8((uint16_t)(get_us() + i)),
+			get_sp() + i,
+			read_8((uint16_t)(get_sp() + i)));
+		if (i < no-1) {
+			text_buffer += sprintf(text_buffer, "\n");
+		}
+	}
+}
+
+#include "mc6809_addressing_modes_cpp.hpp"
+#include "mc6809_instructions_cpp.hpp"
+#include "mc6809_disassembler_cpp.hpp"
+#include "mc6809_run_cpp.hpp"
+#include "mc6809_jit_cpp.hpp"
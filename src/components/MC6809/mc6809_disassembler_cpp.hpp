@@ -1,5 +1,5 @@
 /*
- * mc6809_disassembler.cpp  -  part of MC6809
+ * mc6809_disassembler_cpp.hpp  -  part of MC6809
  *
  * (C)2021-2022 elmerucr
  *
@@ -60,7 +60,7 @@ enum addr_mode_index {
 	// __IML_ 	// immediate 32-bit		// 6309??
 };
 
-const char *mnemonics[133] = {
+static const char *mnemonics[133] = {
 	"abx  ","adca ","adcb ","adda ","addb ","addd ","anda ","andb ",
 	"andcc","asl  ","asla ","aslb ","asr  ","asra ","asrb ","beq  ",
 	"bge  ","bgt  ","bhi  ","bhs  ","bita ","bitb ","bmi  ","ble  ",
@@ -105,7 +105,7 @@ const struct exg_tfr_operand exg_tfr_operands[16] = {
 	{ "?",  true,  false }
 };
 
-enum mnemonics_index opcodes_page_1[256] = {
+static enum mnemonics_index opcodes_page_1[256] = {
 	_NEG,	_ILL,	_ILL,	_COM,	_LSR,	_ILL,	_ROR,	_ASR,	// 0x00
 	_ASL,	_ROL,	_DEC,	_ILL,	_INC,	_TST,	_JMP,	_CLR,
 	_ILL,	_ILL,	_NOP,	_SYNC,	_ILL,	_ILL,	_LBRA,	_LBSR,	// 0x10
@@ -140,7 +140,7 @@ enum mnemonics_index opcodes_page_1[256] = {
 	_EORB,	_ADCB,	_ORB,	_ADDB,	_LDD,	_STD,	_LDU,	_STU
 };
 
-enum mnemonics_index opcodes_page_2[256] = {
+static enum mnemonics_index opcodes_page_2[256] = {
 	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	// 0x00
 	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,
 	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	// 0x10
@@ -175,7 +175,7 @@ enum mnemonics_index opcodes_page_2[256] = {
 	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_LDS,	_STS
 };
 
-enum mnemonics_index opcodes_page_3[256] = {
+static enum mnemonics_index opcodes_page_3[256] = {
 	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	// 0x00
 	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,
 	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	// 0x10
@@ -210,7 +210,7 @@ enum mnemonics_index opcodes_page_3[256] = {
 	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL,	_ILL
 };
 
-enum addr_mode_index addr_mode_page_1[256] = {
+static enum addr_mode_index addr_mode_page_1[256] = {
 	__DIR_, __NOM_, __NOM_, __DIR_, __DIR_, __NOM_, __DIR_,	__DIR_,	// 0x00
 	__DIR_, __DIR_, __DIR_, __NOM_, __DIR_, __DIR_, __NOM_, __DIR_,
 	__NOM_, __NOM_, __INH_, __INH_, __NOM_, __NOM_, __REW_, __REW_,	// 0x10
@@ -245,7 +245,7 @@ enum addr_mode_index addr_mode_page_1[256] = {
 	__EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_, __EXT_
 };
 
-enum addr_mode_index addr_mode_page_2[256] = {
+static enum addr_mode_index addr_mode_page_2[256] = {
 	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x00
 	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
 	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x10
@@ -280,7 +280,7 @@ enum addr_mode_index addr_mode_page_2[256] = {
 	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __EXT_, __EXT_
 };
 
-enum addr_mode_index addr_mode_page_3[256] = {
+static enum addr_mode_index addr_mode_page_3[256] = {
 	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x00
 	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,
 	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_,	// 0x10
@@ -315,7 +315,8 @@ enum addr_mode_index addr_mode_page_3[256] = {
 	__NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_, __NOM_
 };
 
-uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
+template <class bus_t>
+uint16_t mc6809_t<bus_t>::disassemble_instruction(char *buffer, uint16_t address)
 {
 	disassemble_success = true;
 
@@ -367,7 +368,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 
 	enum addr_mode_index mode;
 
-	uint8_t byte = (*read_8)(address++);
+	uint8_t byte = read_8(address++);
 	uint8_t byte2 = 0;
 	uint16_t word = 0;
 	buffer += sprintf(buffer, ",%04x %02x", start_address, byte);
@@ -375,7 +376,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 
 	if (byte == 0x10) {
 		// page 2
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += sprintf(mne_buffer, "%s ",
@@ -400,14 +401,14 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 
 	switch (mode) {
 	case __DIR_:
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += sprintf(mne_buffer,
 			"$%02x", byte);
 		break;
 	case __REB_:
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += sprintf(mne_buffer, "$%04x",
@@ -415,11 +416,11 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 			(uint16_t)((int8_t)byte)));
 		break;
 	case __REW_:
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		word = byte << 8;
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		word |= byte;
@@ -427,26 +428,26 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 			(uint16_t)(address + word));
 		break;
 	case __IMB_:
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += sprintf(mne_buffer,
 			"#$%02x", byte);
 		break;
 	case __IMW_:
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += sprintf(mne_buffer,
 			"#$%02x", byte);
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += sprintf(mne_buffer,
 			"%02x", byte);
 		break;
 	case __IBB_:
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		mne_buffer += sprintf(mne_buffer,
@@ -461,11 +462,11 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 			byte & 0x01 ? '1' : '0');
 		break;
 	case __EXT_:
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		word = byte << 8;
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		word |= byte;
@@ -474,17 +475,17 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 		break;
 	case __IDX_:
 		// read postbyte
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		if (byte == 0b10011111) {
 			// indirect extended
 			mne_buffer += sprintf(mne_buffer, "[");
-			byte = (*read_8)(address++);
+			byte = read_8(address++);
 			buffer += sprintf(buffer, "%02x", byte);
 			bytes_printed++;
 			word = byte << 8;
-			byte = (*read_8)(address++);
+			byte = read_8(address++);
 			buffer += sprintf(buffer, "%02x", byte);
 			bytes_printed++;
 			word |= byte;
@@ -504,7 +505,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 						break;
 					case 0b1000:
 						// 8 bit offset
-						byte2 = (*read_8)(address++);
+						byte2 = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte2);
 						bytes_printed++;
 						mne_buffer += sprintf(mne_buffer,
@@ -514,11 +515,11 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 						break;
 					case 0b1001:
 						// 16 bit offset
-						byte2 = (*read_8)(address++);
+						byte2 = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte2);
 						bytes_printed++;
 						word = byte2 << 8;
-						byte2 = (*read_8)(address++);
+						byte2 = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte2);
 						bytes_printed++;
 						word |= byte2;
@@ -571,7 +572,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 						break;
 					case 0b1100:
 						// const offset pc 8bit, read extra byte
-						byte = (*read_8)(address++);
+						byte = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte);
 						bytes_printed++;
 						mne_buffer += sprintf(mne_buffer,
@@ -580,11 +581,11 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 						break;
 					case 0b1101:
 						// const offs pc 16 bit, read 2 extr bytes
-						byte = (*read_8)(address++);
+						byte = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte);
 						bytes_printed++;
 						word = byte << 8;
-						byte = (*read_8)(address++);
+						byte = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte);
 						bytes_printed++;
 						word |= byte;
@@ -611,7 +612,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 						break;
 					case 0b1000:
 						// indirect 8 bit offset
-						byte2 = (*read_8)(address++);
+						byte2 = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte2);
 						bytes_printed++;
 						mne_buffer += sprintf(mne_buffer,
@@ -621,11 +622,11 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 						break;
 					case 0b1001:
 						// indirect 16 bit offset
-						byte2 = (*read_8)(address++);
+						byte2 = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte2);
 						bytes_printed++;
 						word = byte2 << 8;
-						byte2 = (*read_8)(address++);
+						byte2 = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte2);
 						bytes_printed++;
 						word |= byte2;
@@ -666,7 +667,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 						break;
 					case 0b1100:
 						// indirect const offset pc 8bit, read extra byte
-						byte = (*read_8)(address++);
+						byte = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte);
 						bytes_printed++;
 						mne_buffer += sprintf(mne_buffer,
@@ -675,11 +676,11 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 						break;
 					case 0b1101:
 						// indirect const offs pc 16 bit, read 2 extr bytes
-						byte = (*read_8)(address++);
+						byte = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte);
 						bytes_printed++;
 						word = byte << 8;
-						byte = (*read_8)(address++);
+						byte = read_8(address++);
 						buffer += sprintf(buffer, "%02x", byte);
 						bytes_printed++;
 						word |= byte;
@@ -710,7 +711,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 		}
 		break;
 	case __R1_:
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		if (((exg_tfr_operands[byte >> 4].illegal) || (exg_tfr_operands[byte & 0x0f].illegal)) ||
@@ -725,7 +726,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 		break;
 	case __R2_:
 		// pul/psh system
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		if (byte == 0x00) {
@@ -747,7 +748,7 @@ uint16_t mc6809::disassemble_instruction(char *buffer, uint16_t address)
 		break;
 	case __R3_:
 		// pul/psh user
-		byte = (*read_8)(address++);
+		byte = read_8(address++);
 		buffer += sprintf(buffer, "%02x", byte);
 		bytes_printed++;
 		if (byte == 0x00) {
@@ -1,5 +1,5 @@
 /*
- * mc6809_opcodes.cpp  -  part of MC6809
+ * mc6809_instructions_cpp.hpp  -  part of MC6809
  *
  * (C)2021-2022 elmerucr
  */
@@ -7,29 +7,22 @@
 #include "mc6809.hpp"
 #include <cstdio>
 
-uint8_t  byte;
-uint16_t word;
-uint32_t dword;
-
-/*
- * d_reg is a stand-in temporary variable to ease calculations
- * during individual instructions that deal with the d register
- */
-uint16_t d_reg;
-
-void mc6809::ill(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ill(uint16_t ea)
 {
 	// TODO !!!!!
 	// "NEW": from 6309
 	// push all registers, load vector illegal opcode ....
 }
 
-void mc6809::abx(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::abx(uint16_t ea)
 {
 	xr += br;
 }
 
-void mc6809::adca(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::adca(uint16_t ea)
 {
 	/*
 	 * See: Osborne, A. 1976. An introduction to microcomputers
@@ -38,153 +31,81 @@ void mc6809::adca(uint16_t ea)
 
 	uint8_t old_carry = (is_c_flag_set() ? 1 : 0);
 
-	byte = (*read_8)(ea);
-
-	/*
-	 * Half carry
-	 */
-	if (((ac & 0x0f) + (byte & 0x0f) + old_carry) & 0b00010000) {
-		set_h_flag();
-	} else {
-		clear_h_flag();
-	}
-
-	bool bit_7_carry_in = (((ac & 0x7f) + (byte & 0x7f) + old_carry) & 0x80) ? true : false;
-
+	byte = read_8(ea);
 	word = ac + byte + old_carry;
+	lazy_add_8(ac, byte, word);
 	ac = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	if (carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags(ac);
 }
 
-void mc6809::adcb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::adcb(uint16_t ea)
 {
 	uint8_t old_carry = (is_c_flag_set() ? 1 : 0);
 
-	byte = (*read_8)(ea);
-
-	/*
-	 * Half carry
-	 */
-	if (((br & 0x0f) + (byte & 0x0f) + old_carry) & 0b00010000) {
-		set_h_flag();
-	} else {
-		clear_h_flag();
-	}
-
-	bool bit_7_carry_in = (((br & 0x7f) + (byte & 0x7f) + old_carry) & 0x80) ? true : false;
-
+	byte = read_8(ea);
 	word = br + byte + old_carry;
+	lazy_add_8(br, byte, word);
 	br = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	if (carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags(br);
 }
 
-void mc6809::adda(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::adda(uint16_t ea)
 {
-	byte = (*read_8)(ea);
-
-	/*
-	 * Half carry
-	 */
-	if (((ac & 0x0f) + (byte & 0x0f)) & 0b00010000) {
-		set_h_flag();
-	} else {
-		clear_h_flag();
-	}
-
-	bool bit_7_carry_in = (((ac & 0x7f) + (byte & 0x7f)) & 0x80) ? true : false;
-
+	byte = read_8(ea);
 	word = ac + byte;
+	lazy_add_8(ac, byte, word);
 	ac = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	if (carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags(ac);
 }
 
-void mc6809::addb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::addb(uint16_t ea)
 {
-	byte = (*read_8)(ea);
-
-	/*
-	 * Half carry
-	 */
-	if (((br & 0x0f) + (byte & 0x0f)) & 0b00010000) {
-		set_h_flag();
-	} else {
-		clear_h_flag();
-	}
-
-	bool bit_7_carry_in = (((br & 0x7f) + (byte & 0x7f)) & 0x80) ? true : false;
-
+	byte = read_8(ea);
 	word = br + byte;
+	lazy_add_8(br, byte, word);
 	br = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	if (carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags(br);
 }
 
-void mc6809::addd(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::addd(uint16_t ea)
 {
-	word = ((*read_8)(ea++)) << 8;
-	word |= (*read_8)(ea);
+	word = (read_8(ea++)) << 8;
+	word |= read_8(ea);
 	
 	d_reg = (ac << 8) | br;
 
-	/* no need for half-carry here */
-
-	bool bit_15_carry_in = (((d_reg & 0x7fff) + (word & 0x7fff)) & 0x8000) ? true : false;
-
 	dword = d_reg + word;
+	lazy_add_16(d_reg, word, dword);
 	d_reg = dword & 0xffff;
 	ac = (d_reg & 0xff00) >> 8;
 	br = d_reg & 0xff;
-
-	bool carry = (dword & 0x00010000) ? true : false;
-
-	if(carry != bit_15_carry_in) set_v_flag(); else clear_v_flag();
-	if(carry) set_c_flag(); else clear_c_flag();
-	test_nz_flags_16(d_reg);
 }
 
-void mc6809::anda(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::anda(uint16_t ea)
 {
-	byte = ac & (*read_8)(ea);
-	clear_v_flag();
-	test_nz_flags(byte);
-	ac = byte;
+	ac &= read_8(ea);
+	lazy_logic_8(ac);
 }
 
-void mc6809::andb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::andb(uint16_t ea)
 {
-	byte = br & (*read_8)(ea);
-	clear_v_flag();
-	test_nz_flags(byte);
-	br = byte;
+	br &= read_8(ea);
+	lazy_logic_8(br);
 }
 
-void mc6809::andcc(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::andcc(uint16_t ea)
 {
-	cc &= (*read_8)(ea);
+	materialize_flags();
+	cc &= read_8(ea);
 }
 
-void mc6809::asl(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::asl(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 
 	if (byte & 0x80) set_c_flag(); else clear_c_flag();
 	if (((byte & 0xc0) == 0x80) || ((byte & 0xc0) == 0x40))
@@ -193,10 +114,11 @@ void mc6809::asl(uint16_t ea)
 	byte <<= 1;
 
 	test_nz_flags(byte);
-	(*write_8)(ea, byte);
+	write_8(ea, byte);
 }
 
-void mc6809::asla(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::asla(uint16_t ea)
 {
 	if (ac & 0x80) set_c_flag(); else clear_c_flag();
 	if (((ac & 0xc0) == 0x80) || ((ac & 0xc0) == 0x40))
@@ -207,7 +129,8 @@ void mc6809::asla(uint16_t ea)
 	test_nz_flags(ac);
 }
 
-void mc6809::aslb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::aslb(uint16_t ea)
 {
 	if (br & 0x80) set_c_flag(); else clear_c_flag();
 	if (((br & 0xc0) == 0x80) || ((br & 0xc0) == 0x40))
@@ -218,9 +141,10 @@ void mc6809::aslb(uint16_t ea)
 	test_nz_flags(br);
 }
 
-void mc6809::asr(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::asr(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 
 	if (byte & 0x01) set_c_flag(); else clear_c_flag();
 	bool bit7 = (byte & 0x80) ? true : false;
@@ -229,10 +153,11 @@ void mc6809::asr(uint16_t ea)
 	if (bit7) byte |= 0x80; else byte &= 0x7f;
 
 	test_nz_flags(byte);
-	(*write_8)(ea, byte);
+	write_8(ea, byte);
 }
 
-void mc6809::asra(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::asra(uint16_t ea)
 {
 	if (ac & 0x01) set_c_flag(); else clear_c_flag();
 	bool bit7 = (ac & 0x80) ? true : false;
@@ -243,7 +168,8 @@ void mc6809::asra(uint16_t ea)
 	test_nz_flags(ac);
 }
 
-void mc6809::asrb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::asrb(uint16_t ea)
 {
 	if (br & 0x01) set_c_flag(); else clear_c_flag();
 	bool bit7 = (br & 0x80) ? true : false;
@@ -254,12 +180,14 @@ void mc6809::asrb(uint16_t ea)
 	test_nz_flags(br);
 }
 
-void mc6809::beq(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::beq(uint16_t ea)
 {
 	if (is_z_flag_set()) pc = ea;
 }
 
-void mc6809::bge(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bge(uint16_t ea)
 {
 	// both n and v set  OR  both n and v clear
 	if ((is_n_flag_set() && is_v_flag_set()) || (is_n_flag_clear() && is_v_flag_clear())) {
@@ -267,7 +195,8 @@ void mc6809::bge(uint16_t ea)
 	}
 }
 
-void mc6809::bgt(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bgt(uint16_t ea)
 {
 	// (both n and v set  OR  both n and v clear)  AND  (z clear)
 	if (((is_n_flag_set() && is_v_flag_set()) || (is_n_flag_clear() && is_v_flag_clear())) && is_z_flag_clear()) {
@@ -275,7 +204,8 @@ void mc6809::bgt(uint16_t ea)
 	}
 }
 
-void mc6809::bhi(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bhi(uint16_t ea)
 {
 	if (is_z_flag_clear() && is_c_flag_clear()) {
 		pc = ea;
@@ -289,28 +219,32 @@ void mc6809::bhi(uint16_t ea)
  * E.g. if no borrow was needed (carry clear) after a comparison, then
  * value in register must be higher than or the same as the compared value.
  */
-void mc6809::bhs(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bhs(uint16_t ea)
 {
 	if (is_c_flag_clear()) {
 		pc = ea;
 	}
 }
 
-void mc6809::bita(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bita(uint16_t ea)
 {
-	byte = ac & (*read_8)(ea);
+	byte = ac & read_8(ea);
 	clear_v_flag();
 	test_nz_flags(byte);
 }
 
-void mc6809::bitb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bitb(uint16_t ea)
 {
-	byte = br & (*read_8)(ea);
+	byte = br & read_8(ea);
 	clear_v_flag();
 	test_nz_flags(byte);
 }
 
-void mc6809::ble(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ble(uint16_t ea)
 {
 	if (is_z_flag_set() || (is_n_flag_set() && is_v_flag_clear()) || (is_n_flag_clear() && is_v_flag_set())) {
 		pc = ea;
@@ -324,7 +258,8 @@ void mc6809::ble(uint16_t ea)
  * E.g. if a borrow was needed (carry set) after a comparison, the
  * value in the register must be lower than the compared value.
  */
-void mc6809::blo(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::blo(uint16_t ea)
 {
 	if (is_c_flag_set()) {
 		pc = ea;
@@ -334,214 +269,185 @@ void mc6809::blo(uint16_t ea)
 /*
  * bls - Branch if Lower or Same
  */
-void mc6809::bls(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bls(uint16_t ea)
 {
 	if (is_c_flag_set() || is_z_flag_set()) {
 		pc = ea;
 	}
 }
 
-void mc6809::blt(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::blt(uint16_t ea)
 {
 	if ((is_n_flag_set() && is_v_flag_clear()) || (is_n_flag_clear() && is_v_flag_set())) {
 		pc = ea;
 	}
 }
 
-void mc6809::bmi(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bmi(uint16_t ea)
 {
 	if (is_n_flag_set()) {
 		pc = ea;
 	}
 }
 
-void mc6809::bne(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bne(uint16_t ea)
 {
 	if (is_z_flag_clear()) {
 		pc = ea;
 	}
 }
 
-void mc6809::bpl(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bpl(uint16_t ea)
 {
 	if (is_n_flag_clear()) {
 		pc = ea;
 	}
 }
 
-void mc6809::bra(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bra(uint16_t ea)
 {
 	pc = ea;
 }
 
-void mc6809::brn(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::brn(uint16_t ea)
 {
 	// does essentially nothing
 }
 
-void mc6809::bsr(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bsr(uint16_t ea)
 {
 	push_sp(pc & 0x00ff);
 	push_sp((pc & 0xff00) >> 8);
 	pc = ea;
 }
 
-void mc6809::bvc(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bvc(uint16_t ea)
 {
 	if (is_v_flag_clear()) {
 		pc = ea;
 	}
 }
 
-void mc6809::bvs(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::bvs(uint16_t ea)
 {
 	if (is_v_flag_set()) {
 		pc = ea;
 	}
 }
 
-void mc6809::clr(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::clr(uint16_t ea)
 {
-	(*write_8)(ea, 0x00);
-	clear_n_flag();
-	set_z_flag();
-	clear_v_flag();
-	clear_c_flag();
+	write_8(ea, 0x00);
+	lazy_sub_8(0, 0, 0);	// 0 - 0 gives n=0, z=1, v=0, c=0
 }
 
-void mc6809::clra(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::clra(uint16_t ea)
 {
 	ac = 0x00;
-	clear_n_flag();
-	set_z_flag();
-	clear_v_flag();
-	clear_c_flag();
+	lazy_sub_8(0, 0, 0);	// 0 - 0 gives n=0, z=1, v=0, c=0
 }
 
-void mc6809::clrb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::clrb(uint16_t ea)
 {
 	br = 0x00;
-	clear_n_flag();
-	set_z_flag();
-	clear_v_flag();
-	clear_c_flag();
+	lazy_sub_8(0, 0, 0);	// 0 - 0 gives n=0, z=1, v=0, c=0
 }
 
-void mc6809::cmpa(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::cmpa(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	word = ac - byte;
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((ac ^ word) & 0x80) && ((ac ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
-	byte = word & 0xff;
-	test_nz_flags(byte);
+	lazy_sub_8(ac, byte, word);
 }
 
-void mc6809::cmpb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::cmpb(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	word = br - byte;
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((br ^ word) & 0x80) && ((br ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
-	byte = word & 0xff;
-	test_nz_flags(byte);
+	lazy_sub_8(br, byte, word);
 }
 
-void mc6809::cmpd(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::cmpd(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	word = (*read_8)(ea++) << 8;
-	word |= (*read_8)((uint16_t)ea);
+	word = read_8(ea++) << 8;
+	word |= read_8((uint16_t)ea);
 	d_reg = (ac << 8) | br;
 	dword = d_reg - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((d_reg ^ dword) & 0x8000) && ((d_reg ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	lazy_sub_16(d_reg, word, dword);
 }
 
-void mc6809::cmpu(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::cmpu(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	word = (*read_8)(ea++) << 8;
-	word |= (*read_8)((uint16_t)ea);
+	word = read_8(ea++) << 8;
+	word |= read_8((uint16_t)ea);
 	dword = us - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((us ^ dword) & 0x8000) && ((us ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	lazy_sub_16(us, word, dword);
 }
 
-void mc6809::cmps(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::cmps(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	word = (*read_8)(ea++) << 8;
-	word |= (*read_8)((uint16_t)ea);
+	word = read_8(ea++) << 8;
+	word |= read_8((uint16_t)ea);
 	dword = sp - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((sp ^ dword) & 0x8000) && ((sp ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	lazy_sub_16(sp, word, dword);
 }
 
-void mc6809::cmpx(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::cmpx(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	word = (*read_8)(ea++) << 8;
-	word |= (*read_8)((uint16_t)ea);
+	word = read_8(ea++) << 8;
+	word |= read_8((uint16_t)ea);
 	dword = xr - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((xr ^ dword) & 0x8000) && ((xr ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	lazy_sub_16(xr, word, dword);
 }
 
-void mc6809::cmpy(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::cmpy(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	word = (*read_8)(ea++) << 8;
-	word |= (*read_8)((uint16_t)ea);
+	word = read_8(ea++) << 8;
+	word |= read_8((uint16_t)ea);
 	dword = yr - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((yr ^ dword) & 0x8000) && ((yr ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
-
-	word = dword & 0xffff;
-	test_nz_flags_16(word);
+	lazy_sub_16(yr, word, dword);
 }
 
-void mc6809::com(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::com(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	byte = ~byte;
-	(*write_8)(ea, byte);
+	write_8(ea, byte);
 	test_nz_flags(byte);
 	clear_v_flag();
 	set_c_flag();
 }
 
-void mc6809::coma(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::coma(uint16_t ea)
 {
 	ac = ~ac;
 	test_nz_flags(ac);
@@ -549,7 +455,8 @@ void mc6809::coma(uint16_t ea)
 	set_c_flag();
 }
 
-void mc6809::comb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::comb(uint16_t ea)
 {
 	br = ~br;
 	test_nz_flags(br);
@@ -557,12 +464,17 @@ void mc6809::comb(uint16_t ea)
 	set_c_flag();
 }
 
-void mc6809::cwai(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::cwai(uint16_t ea)
 {
-	//
+	materialize_flags();
+	cc &= read_8(ea);
+	push_entire_state();
+	state = STATE_CWAI;
 }
 
-void mc6809::daa(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::daa(uint16_t ea)
 {
 	if (is_h_flag_set() || ((ac & 0x0f) > 9))
 		byte = 0x06; else byte = 0;
@@ -575,70 +487,56 @@ void mc6809::daa(uint16_t ea)
 	test_nz_flags(ac);
 }
 
-void mc6809::dec(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::dec(uint16_t ea)
 {
-	byte = (*read_8)(ea);
-
-	bool bit_7_carry_in = (((byte & 0x7f) + 0x7f) & 0x80) ? true : false;
-
+	byte = read_8(ea);
 	word = byte + 0xff;
+	lazy_inc_dec_8(byte, 0xff, word);
 	byte = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	test_nz_flags(byte);
-
-	(*write_8)(ea, byte);
+	write_8(ea, byte);
 }
 
-void mc6809::deca(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::deca(uint16_t ea)
 {
-	bool bit_7_carry_in = (((ac & 0x7f) + 0x7f) & 0x80) ? true : false;
-
 	word = ac + 0xff;		// do an addition
+	lazy_inc_dec_8(ac, 0xff, word);
 	ac = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	test_nz_flags(ac);
 }
 
-void mc6809::decb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::decb(uint16_t ea)
 {
-	bool bit_7_carry_in = (((br & 0x7f) + 0x7f) & 0x80) ? true : false;
-
 	word = br + 0xff;		// do an addition
+	lazy_inc_dec_8(br, 0xff, word);
 	br = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	test_nz_flags(br);
 }
 
-void mc6809::eora(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::eora(uint16_t ea)
 {
-	ac ^= (*read_8)(ea);
-	clear_v_flag();
-	test_nz_flags(ac);
+	ac ^= read_8(ea);
+	lazy_logic_8(ac);
 }
 
-void mc6809::eorb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::eorb(uint16_t ea)
 {
-	br ^= (*read_8)(ea);
-	clear_v_flag();
-	test_nz_flags(br);
+	br ^= read_8(ea);
+	lazy_logic_8(br);
 }
 
-void mc6809::exg(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::exg(uint16_t ea)
 {
 	/* illegal combinations do nothing */
 
 	/* when the sp is written to, it enables nmi's */
 
-	switch ((*read_8)(ea)) {
+	materialize_flags();
+
+	switch (read_8(ea)) {
 		/*
 		 * exchange 16 bit registers
 		 */
@@ -713,62 +611,48 @@ void mc6809::exg(uint16_t ea)
 	}
 }
 
-void mc6809::inc(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::inc(uint16_t ea)
 {
-	byte = (*read_8)(ea);
-
-	bool bit_7_carry_in = (((byte & 0x7f) + 0x01) & 0x80) ? true : false;
-
+	byte = read_8(ea);
 	word = byte + 0x01;
+	lazy_inc_dec_8(byte, 0x01, word);
 	byte = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	test_nz_flags(byte);
-
-	(*write_8)(ea, byte);
+	write_8(ea, byte);
 }
 
-void mc6809::inca(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::inca(uint16_t ea)
 {
-	bool bit_7_carry_in = (((ac & 0x7f) + 0x01) & 0x80) ? true : false;
-
 	word = ac + 0x01;		// do an addition
+	lazy_inc_dec_8(ac, 0x01, word);
 	ac = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	test_nz_flags(ac);
 }
 
-void mc6809::incb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::incb(uint16_t ea)
 {
-	bool bit_7_carry_in = (((br & 0x7f) + 0x01) & 0x80) ? true : false;
-
 	word = br + 0x01;		// do an addition
+	lazy_inc_dec_8(br, 0x01, word);
 	br = word & 0x00ff;
-
-	bool carry = (word & 0x0100) ? true : false;
-
-	if (carry != bit_7_carry_in) set_v_flag(); else clear_v_flag();
-	test_nz_flags(br);
 }
 
-void mc6809::jmp(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::jmp(uint16_t ea)
 {
 	pc = ea;
 }
 
-void mc6809::jsr(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::jsr(uint16_t ea)
 {
 	push_sp(pc & 0x00ff);
 	push_sp((pc & 0xff00) >> 8);
 	pc = ea;
 }
 
-void mc6809::lbeq(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbeq(uint16_t ea)
 {
 	if (is_z_flag_set()) {
 		pc = ea;
@@ -776,7 +660,8 @@ void mc6809::lbeq(uint16_t ea)
 	}
 }
 
-void mc6809::lbge(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbge(uint16_t ea)
 {
 	// both n and v set  OR  both n and v clear
 	if ((is_n_flag_set() && is_v_flag_set()) || (is_n_flag_clear() && is_v_flag_clear())) {
@@ -785,7 +670,8 @@ void mc6809::lbge(uint16_t ea)
 	}
 }
 
-void mc6809::lbgt(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbgt(uint16_t ea)
 {
 	// (both n and v set  OR  both n and v clear)  AND  (z clear)
 	if (((is_n_flag_set() && is_v_flag_set()) || (is_n_flag_clear() && is_v_flag_clear())) && is_z_flag_clear()) {
@@ -794,7 +680,8 @@ void mc6809::lbgt(uint16_t ea)
 	}
 }
 
-void mc6809::lbhi(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbhi(uint16_t ea)
 {
 	if (is_z_flag_clear() && is_c_flag_clear()) {
 		pc = ea;
@@ -809,7 +696,8 @@ void mc6809::lbhi(uint16_t ea)
  * E.g. if no borrow was needed (carry clear) after a comparison, then
  * value in register must be higher or the same as the compared value.
  */
-void mc6809::lbhs(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbhs(uint16_t ea)
 {
 	if (is_c_flag_clear()) {
 		pc = ea;
@@ -817,7 +705,8 @@ void mc6809::lbhs(uint16_t ea)
 	}
 }
 
-void mc6809::lble(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lble(uint16_t ea)
 {
 	if (is_z_flag_set() || (is_n_flag_set() && is_v_flag_clear()) || (is_n_flag_clear() && is_v_flag_set())) {
 		pc = ea;
@@ -832,7 +721,8 @@ void mc6809::lble(uint16_t ea)
  * E.g. if a borrow was needed (carry set) after a comparison, the
  * value in the register must be lower than the compared value.
  */
-void mc6809::lblo(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lblo(uint16_t ea)
 {
 	if (is_c_flag_set()) {
 		pc = ea;
@@ -843,7 +733,8 @@ void mc6809::lblo(uint16_t ea)
 /*
  * bls - Branch if Lower or Same
  */
-void mc6809::lbls(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbls(uint16_t ea)
 {
 	if (is_c_flag_set() || is_z_flag_set()) {
 		pc = ea;
@@ -851,7 +742,8 @@ void mc6809::lbls(uint16_t ea)
 	}
 }
 
-void mc6809::lblt(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lblt(uint16_t ea)
 {
 	if ((is_n_flag_set() && is_v_flag_clear()) || (is_n_flag_clear() && is_v_flag_set())) {
 		pc = ea;
@@ -859,7 +751,8 @@ void mc6809::lblt(uint16_t ea)
 	}
 }
 
-void mc6809::lbmi(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbmi(uint16_t ea)
 {
 	if (is_n_flag_set()) {
 		pc = ea;
@@ -867,7 +760,8 @@ void mc6809::lbmi(uint16_t ea)
 	}
 }
 
-void mc6809::lbne(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbne(uint16_t ea)
 {
 	if (is_z_flag_clear()) {
 		pc = ea;
@@ -875,7 +769,8 @@ void mc6809::lbne(uint16_t ea)
 	}
 }
 
-void mc6809::lbpl(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbpl(uint16_t ea)
 {
 	if (is_n_flag_clear()) {
 		pc = ea;
@@ -883,24 +778,28 @@ void mc6809::lbpl(uint16_t ea)
 	}
 }
 
-void mc6809::lbra(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbra(uint16_t ea)
 {
 	pc = ea;
 }
 
-void mc6809::lbrn(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbrn(uint16_t ea)
 {
 	// does essentially nothing
 }
 
-void mc6809::lbsr(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbsr(uint16_t ea)
 {
 	push_sp(pc & 0x00ff);
 	push_sp((pc & 0xff00) >> 8);
 	pc = ea;
 }
 
-void mc6809::lbvc(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbvc(uint16_t ea)
 {
 	if (is_v_flag_clear()) {
 		pc = ea;
@@ -908,7 +807,8 @@ void mc6809::lbvc(uint16_t ea)
 	}
 }
 
-void mc6809::lbvs(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lbvs(uint16_t ea)
 {
 	if (is_v_flag_set()) {
 		pc = ea;
@@ -916,77 +816,79 @@ void mc6809::lbvs(uint16_t ea)
 	}
 }
 
-void mc6809::lda(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lda(uint16_t ea)
 {
-	ac = (*read_8)(ea);
-	clear_v_flag();
-	test_nz_flags(ac);
+	ac = read_8(ea);
+	lazy_logic_8(ac);
 }
 
-void mc6809::ldb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ldb(uint16_t ea)
 {
-	br = (*read_8)(ea);
-	clear_v_flag();
-	test_nz_flags(br);
+	br = read_8(ea);
+	lazy_logic_8(br);
 }
 
-void mc6809::ldd(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ldd(uint16_t ea)
 {
-	ac = (*read_8)(ea++);
-	br = (*read_8)((uint16_t)ea);
-	d_reg = (ac << 8) | br;
-	clear_v_flag();
-	test_nz_flags_16(d_reg);
+	ac = read_8(ea++);
+	br = read_8((uint16_t)ea);
+	lazy_logic_16((ac << 8) | br);
 }
 
-void mc6809::lds(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lds(uint16_t ea)
 {
-	sp = (*read_8)(ea++) << 8;
-	sp |= (*read_8)((uint16_t)ea);
-	clear_v_flag();
-	test_nz_flags_16(sp);
+	sp = read_8(ea++) << 8;
+	sp |= read_8((uint16_t)ea);
+	lazy_logic_16(sp);
 
 	// a write to system stackpointer enables nmi's
 	nmi_enabled = true;
 }
 
-void mc6809::ldu(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ldu(uint16_t ea)
 {
-	us = (*read_8)(ea++) << 8;
-	us |= (*read_8)((uint16_t)ea);
-	clear_v_flag();
-	test_nz_flags_16(us);
+	us = read_8(ea++) << 8;
+	us |= read_8((uint16_t)ea);
+	lazy_logic_16(us);
 }
 
-void mc6809::ldx(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ldx(uint16_t ea)
 {
-	xr = (*read_8)(ea++) << 8;
-	xr |= (*read_8)((uint16_t)ea);
-	clear_v_flag();
-	test_nz_flags_16(xr);
+	xr = read_8(ea++) << 8;
+	xr |= read_8((uint16_t)ea);
+	lazy_logic_16(xr);
 }
 
-void mc6809::ldy(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ldy(uint16_t ea)
 {
-	yr = (*read_8)(ea++) << 8;
-	yr |= (*read_8)((uint16_t)ea);
-	clear_v_flag();
-	test_nz_flags_16(yr);
+	yr = read_8(ea++) << 8;
+	yr |= read_8((uint16_t)ea);
+	lazy_logic_16(yr);
 }
 
-void mc6809::leax(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::leax(uint16_t ea)
 {
 	test_z_flag_16(ea);
 	xr = ea;
 }
 
-void mc6809::leay(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::leay(uint16_t ea)
 {
 	test_z_flag_16(ea);
 	yr = ea;
 }
 
-void mc6809::leas(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::leas(uint16_t ea)
 {
 	test_z_flag_16(ea);
 	sp = ea;
@@ -995,23 +897,26 @@ void mc6809::leas(uint16_t ea)
 	nmi_enabled = true;
 }
 
-void mc6809::leau(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::leau(uint16_t ea)
 {
 	test_z_flag_16(ea);
 	us = ea;
 }
 
-void mc6809::lsr(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lsr(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	if (byte & 0x01) set_c_flag(); else clear_c_flag();
 	byte >>= 1;
 	test_z_flag(byte);
 	clear_n_flag();
-	(*write_8)(ea, byte);
+	write_8(ea, byte);
 }
 
-void mc6809::lsra(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lsra(uint16_t ea)
 {
 	if (ac & 0x01) set_c_flag(); else clear_c_flag();
 	ac >>= 1;
@@ -1019,7 +924,8 @@ void mc6809::lsra(uint16_t ea)
 	clear_n_flag();
 }
 
-void mc6809::lsrb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::lsrb(uint16_t ea)
 {
 	if (br & 0x01) set_c_flag(); else clear_c_flag();
 	br >>= 1;
@@ -1027,7 +933,8 @@ void mc6809::lsrb(uint16_t ea)
 	clear_n_flag();
 }
 
-void mc6809::mul(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::mul(uint16_t ea)
 {
 	d_reg = ac * br;
 	test_z_flag_16(d_reg);
@@ -1036,64 +943,63 @@ void mc6809::mul(uint16_t ea)
 	if (br & 0x80) set_c_flag(); else clear_c_flag();
 }
 
-void mc6809::neg(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::neg(uint16_t ea)
 {
-	byte = (*read_8)(ea);
-	if (byte == 0x80) set_v_flag(); else clear_v_flag();
-	if (byte == 0x00) clear_c_flag(); else set_c_flag();
-	byte = ~byte;
-	byte++;
-	test_nz_flags(byte);
-	(*write_8)(ea, byte);
+	byte = read_8(ea);
+	word = 0 - byte;
+	lazy_sub_8(0, byte, word);
+	byte = word & 0xff;
+	write_8(ea, byte);
 }
 
-void mc6809::nega(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::nega(uint16_t ea)
 {
-	if (ac == 0x80) set_v_flag(); else clear_v_flag();
-	if (ac == 0x00) clear_c_flag(); else set_c_flag();
-	ac = ~ac;
-	ac++;
-	test_nz_flags(ac);
+	word = 0 - ac;
+	lazy_sub_8(0, ac, word);
+	ac = word & 0xff;
 }
 
-void mc6809::negb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::negb(uint16_t ea)
 {
-	if (br == 0x80) set_v_flag(); else clear_v_flag();
-	if (br == 0x00) clear_c_flag(); else set_c_flag();
-	br = ~br;
-	br++;
-	test_nz_flags(br);
+	word = 0 - br;
+	lazy_sub_8(0, br, word);
+	br = word & 0xff;
 }
 
-void mc6809::nop(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::nop(uint16_t ea)
 {
 	// does nothing
 }
 
-void mc6809::ora(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ora(uint16_t ea)
 {
-	byte = ac | (*read_8)(ea);
-	clear_v_flag();
-	test_nz_flags(byte);
-	ac = byte;
+	ac |= read_8(ea);
+	lazy_logic_8(ac);
 }
 
-void mc6809::orb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::orb(uint16_t ea)
 {
-	byte = br | (*read_8)(ea);
-	clear_v_flag();
-	test_nz_flags(byte);
-	br = byte;
+	br |= read_8(ea);
+	lazy_logic_8(br);
 }
 
-void mc6809::orcc(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::orcc(uint16_t ea)
 {
-	cc |= (*read_8)(ea);
+	materialize_flags();
+	cc |= read_8(ea);
 }
 
-void mc6809::page2(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::page2(uint16_t ea)
 {
-	uint8_t opcode = (*read_8)(pc++);
+	uint8_t opcode = read_8(pc++);
 	cycles += cycles_page2[opcode];
 
 	bool am_legal;
@@ -1102,9 +1008,10 @@ void mc6809::page2(uint16_t ea)
 	(this->*opcodes_page2[opcode])(effective_address);
 }
 
-void mc6809::page3(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::page3(uint16_t ea)
 {
-	uint8_t opcode = (*read_8)(pc++);
+	uint8_t opcode = read_8(pc++);
 	cycles += cycles_page3[opcode];
 
 	bool am_legal;
@@ -1113,9 +1020,11 @@ void mc6809::page3(uint16_t ea)
 	(this->*opcodes_page3[opcode])(effective_address);
 }
 
-void mc6809::pshs(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::pshs(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
+	if (byte & 0x01) materialize_flags();
 
 	if (byte & 0x80) { push_sp(pc & 0x00ff); push_sp((pc & 0xff00) >> 8); cycles += 2; }
 	if (byte & 0x40) { push_sp(us & 0x00ff); push_sp((us & 0xff00) >> 8); cycles += 2; }
@@ -1127,9 +1036,11 @@ void mc6809::pshs(uint16_t ea)
 	if (byte & 0x01) { push_sp(cc);                                       cycles += 1; }
 }
 
-void mc6809::pshu(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::pshu(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
+	if (byte & 0x01) materialize_flags();
 
 	if (byte & 0x80) { push_us(pc & 0x00ff); push_us((pc & 0xff00) >> 8); cycles += 2; }
 	if (byte & 0x40) { push_us(sp & 0x00ff); push_us((sp & 0xff00) >> 8); cycles += 2; }
@@ -1141,9 +1052,11 @@ void mc6809::pshu(uint16_t ea)
 	if (byte & 0x01) { push_us(cc);                                       cycles += 1; }
 }
 
-void mc6809::puls(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::puls(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
+	if (byte & 0x01) materialize_flags();
 
 	if (byte & 0x01) { cc   = pull_sp();                                    cycles += 1; }
 	if (byte & 0x02) { ac   = pull_sp();                                    cycles += 1; }
@@ -1155,9 +1068,11 @@ void mc6809::puls(uint16_t ea)
 	if (byte & 0x80) { word = pull_sp() << 8; word |= pull_sp(); pc = word; cycles += 2; }
 }
 
-void mc6809::pulu(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::pulu(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
+	if (byte & 0x01) materialize_flags();
 
 	if (byte & 0x01) { cc   = pull_us();                                    cycles += 1; }
 	if (byte & 0x02) { ac   = pull_us();                                    cycles += 1; }
@@ -1169,22 +1084,24 @@ void mc6809::pulu(uint16_t ea)
 	if (byte & 0x80) { word = pull_us() << 8; word |= pull_us(); pc = word; cycles += 2; }
 }
 
-void mc6809::rol(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::rol(uint16_t ea)
 {
-	byte = (*read_8)(ea);
-	uint8_t old_carry = cc & C_FLAG;
+	byte = read_8(ea);
+	uint8_t old_carry = is_c_flag_set() ? C_FLAG : 0;
 	if (((byte & 0b11000000) == 0b01000000) || ((byte & 0b11000000) == 0b10000000))
 		set_v_flag(); else clear_v_flag();
 	if (byte & 0x80) set_c_flag(); else clear_c_flag();
 	byte <<= 1;
 	byte |= old_carry;
 	test_nz_flags(byte);
-	(*write_8)(ea, byte);
+	write_8(ea, byte);
 }
 
-void mc6809::rola(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::rola(uint16_t ea)
 {
-	uint8_t old_carry = cc & C_FLAG;
+	uint8_t old_carry = is_c_flag_set() ? C_FLAG : 0;
 	if (((ac & 0b11000000) == 0b01000000) || ((ac & 0b11000000) == 0b10000000))
 		set_v_flag(); else clear_v_flag();
 	if (ac & 0x80) set_c_flag(); else clear_c_flag();
@@ -1193,9 +1110,10 @@ void mc6809::rola(uint16_t ea)
 	test_nz_flags(ac);
 }
 
-void mc6809::rolb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::rolb(uint16_t ea)
 {
-	uint8_t old_carry = cc & C_FLAG;
+	uint8_t old_carry = is_c_flag_set() ? C_FLAG : 0;
 	if (((br & 0b11000000) == 0b01000000) || ((br & 0b11000000) == 0b10000000))
 		set_v_flag(); else clear_v_flag();
 	if (br & 0x80) set_c_flag(); else clear_c_flag();
@@ -1204,18 +1122,20 @@ void mc6809::rolb(uint16_t ea)
 	test_nz_flags(br);
 }
 
-void mc6809::ror(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::ror(uint16_t ea)
 {
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	bool old_carry = is_c_flag_set();
 	if (byte & 0x01) set_c_flag(); else clear_c_flag();
 	byte >>= 1;
 	if (old_carry) byte |= 0x80;
 	test_nz_flags(byte);
-	(*write_8)(ea, byte);
+	write_8(ea, byte);
 }
 
-void mc6809::rora(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::rora(uint16_t ea)
 {
 	bool old_carry = is_c_flag_set();
 	if (ac & 0x01) set_c_flag(); else clear_c_flag();
@@ -1224,7 +1144,8 @@ void mc6809::rora(uint16_t ea)
 	test_nz_flags(ac);
 }
 
-void mc6809::rorb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::rorb(uint16_t ea)
 {
 	bool old_carry = is_c_flag_set();
 	if (br & 0x01) set_c_flag(); else clear_c_flag();
@@ -1233,8 +1154,10 @@ void mc6809::rorb(uint16_t ea)
 	test_nz_flags(br);
 }
 
-void mc6809::rti(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::rti(uint16_t ea)
 {
+	materialize_flags();
 	cc = pull_sp();
 	if (is_e_flag_set()) {
 		ac = pull_sp();
@@ -1257,151 +1180,134 @@ void mc6809::rti(uint16_t ea)
 	pc = word;
 }
 
-void mc6809::rts(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::rts(uint16_t ea)
 {
 	word = pull_sp() << 8;
 	word |= pull_sp();
 	pc = word;
 }
 
-void mc6809::sbca(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::sbca(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	word = ac - byte - (is_c_flag_set() ? 1 : 0);
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((ac ^ word) & 0x80) && ((ac ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
+	lazy_sub_8(ac, byte, word);
 	ac = word & 0xff;
-	test_nz_flags(ac);
 }
 
-void mc6809::sbcb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::sbcb(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	word = br - byte - (is_c_flag_set() ? 1 : 0);
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((br ^ word) & 0x80) && ((br ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
+	lazy_sub_8(br, byte, word);
 	br = word & 0xff;
-	test_nz_flags(br);
 }
 
-void mc6809::sex(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::sex(uint16_t ea)
 {
 	if (br & 0x80) ac = 0xff; else ac = 0x00;
 	test_nz_flags(br);
 }
 
-void mc6809::sta(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::sta(uint16_t ea)
 {
-	(*write_8)(ea, ac);
-	clear_v_flag();
-	test_nz_flags(ac);
+	write_8(ea, ac);
+	lazy_logic_8(ac);
 }
 
-void mc6809::stb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::stb(uint16_t ea)
 {
-	(*write_8)(ea, br);
-	clear_v_flag();
-	test_nz_flags(br);
+	write_8(ea, br);
+	lazy_logic_8(br);
 }
 
-void mc6809::std(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::std(uint16_t ea)
 {
-	(*write_8)(ea++, ac);
-	(*write_8)(ea, br);
-	d_reg = (ac << 8) | br;
-	clear_v_flag();
-	test_nz_flags_16(d_reg);
+	write_8(ea++, ac);
+	write_8(ea, br);
+	lazy_logic_16((ac << 8) | br);
 }
 
-void mc6809::stu(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::stu(uint16_t ea)
 {
-	(*write_8)(ea++, us >> 8);
-	(*write_8)(ea, us & 0xff);
-	clear_v_flag();
-	test_nz_flags_16(us);
+	write_8(ea++, us >> 8);
+	write_8(ea, us & 0xff);
+	lazy_logic_16(us);
 }
 
-void mc6809::sts(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::sts(uint16_t ea)
 {
-	(*write_8)(ea++, sp >> 8);
-	(*write_8)(ea, sp & 0xff);
-	clear_v_flag();
-	test_nz_flags_16(sp);
+	write_8(ea++, sp >> 8);
+	write_8(ea, sp & 0xff);
+	lazy_logic_16(sp);
 }
 
-void mc6809::stx(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::stx(uint16_t ea)
 {
-	(*write_8)(ea++, xr >> 8);
-	(*write_8)(ea, xr & 0xff);
-	clear_v_flag();
-	test_nz_flags_16(xr);
+	write_8(ea++, xr >> 8);
+	write_8(ea, xr & 0xff);
+	lazy_logic_16(xr);
 }
 
-void mc6809::sty(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::sty(uint16_t ea)
 {
-	(*write_8)(ea++, yr >> 8);
-	(*write_8)(ea, yr & 0xff);
-	clear_v_flag();
-	test_nz_flags_16(yr);
+	write_8(ea++, yr >> 8);
+	write_8(ea, yr & 0xff);
+	lazy_logic_16(yr);
 }
 
-void mc6809::suba(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::suba(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	word = ac - byte;
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((ac ^ word) & 0x80) && ((ac ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
+	lazy_sub_8(ac, byte, word);
 	ac = word & 0xff;
-	test_nz_flags(ac);
 }
 
-void mc6809::subb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::subb(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	byte = (*read_8)(ea);
+	byte = read_8(ea);
 	word = br - byte;
-
-	if (word > 255) set_c_flag(); else clear_c_flag();
-
-	if (((br ^ word) & 0x80) && ((br ^ byte) & 0x80)) set_v_flag(); else clear_v_flag();
-
+	lazy_sub_8(br, byte, word);
 	br = word & 0xff;
-	test_nz_flags(br);
 }
 
-void mc6809::subd(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::subd(uint16_t ea)
 {
 	/* code inspired by virtualc64 */
-	word = (*read_8)(ea++) << 8;
-	word |= (*read_8)((uint16_t)ea);
+	word = read_8(ea++) << 8;
+	word |= read_8((uint16_t)ea);
 	
 	d_reg = (ac << 8) | br;
 
 	dword = d_reg - word;
-
-	if (dword > 65535) set_c_flag(); else clear_c_flag();
-
-	if (((d_reg ^ dword) & 0x8000) && ((d_reg ^ word) & 0x8000)) set_v_flag(); else clear_v_flag();
+	lazy_sub_16(d_reg, word, dword);
 
 	d_reg = dword & 0xffff;
 	ac = (d_reg & 0xff00) >> 8;
 	br = d_reg & 0xff;
-	test_nz_flags_16(d_reg);
 }
 
-void mc6809::swi(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::swi(uint16_t ea)
 {
 	set_e_flag();
 	push_sp(pc & 0x00ff);
@@ -1415,15 +1321,17 @@ void mc6809::swi(uint16_t ea)
 	push_sp(dp);
 	push_sp(br);
 	push_sp(ac);
+	materialize_flags();
 	push_sp(cc);
 	set_i_flag();
 	set_f_flag();
 	pc = 0;
-	pc = ((*read_8)(VECTOR_SWI)) << 8;
-	pc |= (*read_8)(VECTOR_SWI+1);
+	pc = (read_8(VECTOR_SWI)) << 8;
+	pc |= read_8(VECTOR_SWI+1);
 }
 
-void mc6809::swi2(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::swi2(uint16_t ea)
 {
 	set_e_flag();
 	push_sp(pc & 0x00ff);
@@ -1437,13 +1345,15 @@ void mc6809::swi2(uint16_t ea)
 	push_sp(dp);
 	push_sp(br);
 	push_sp(ac);
+	materialize_flags();
 	push_sp(cc);
 	pc = 0;
-	pc = ((*read_8)(VECTOR_SWI2)) << 8;
-	pc |= (*read_8)(VECTOR_SWI2+1);
+	pc = (read_8(VECTOR_SWI2)) << 8;
+	pc |= read_8(VECTOR_SWI2+1);
 }
 
-void mc6809::swi3(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::swi3(uint16_t ea)
 {
 	set_e_flag();
 	push_sp(pc & 0x00ff);
@@ -1457,24 +1367,29 @@ void mc6809::swi3(uint16_t ea)
 	push_sp(dp);
 	push_sp(br);
 	push_sp(ac);
+	materialize_flags();
 	push_sp(cc);
 	pc = 0;
-	pc = ((*read_8)(VECTOR_SWI3)) << 8;
-	pc |= (*read_8)(VECTOR_SWI3+1);
+	pc = (read_8(VECTOR_SWI3)) << 8;
+	pc |= read_8(VECTOR_SWI3+1);
 }
 
-void mc6809::sync(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::sync(uint16_t ea)
 {
-	//
+	state = STATE_SYNC;
 }
 
-void mc6809::tfr(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::tfr(uint16_t ea)
 {
 	/* illegal combinations do nothing */
 
 	/* when sp is written to, nmi's are enabled */
 
-	switch ((*read_8)(ea)) {
+	materialize_flags();
+
+	switch (read_8(ea)) {
 		/*
 		 * transfer 16 bit registers
 		 */
@@ -1549,20 +1464,20 @@ void mc6809::tfr(uint16_t ea)
 	}
 }
 
-void mc6809::tst(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::tst(uint16_t ea)
 {
-	test_nz_flags((*read_8)(ea));
-	clear_v_flag();
+	lazy_logic_8(read_8(ea));
 }
 
-void mc6809::tsta(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::tsta(uint16_t ea)
 {
-	test_nz_flags(ac);
-	clear_v_flag();
+	lazy_logic_8(ac);
 }
 
-void mc6809::tstb(uint16_t ea)
+template <class bus_t>
+void mc6809_t<bus_t>::tstb(uint16_t ea)
 {
-	test_nz_flags(br);
-	clear_v_flag();
+	lazy_logic_8(br);
 }
@@ -0,0 +1,839 @@
+/*
+ * mc6809_jit_cpp.hpp  -  part of MC6809
+ *
+ * (C)2021-2022 elmerucr
+ */
+
+/*
+ * Native code for translated blocks (x86-64 Linux hosts only). A block
+ * that keeps being entered by run() is compiled into one host function
+ * that executes its instructions in order, and returns how many of them
+ * it executed. Everything else (cold code, blocks not yet compiled, the
+ * instructions in between blocks, interrupts) stays with the block
+ * engine, which also decides when a compiled block may be entered.
+ *
+ * Guest registers live in the cpu object, rbx points to it. Common
+ * loads, stores, alu and index instructions are emitted inline, with
+ * condition codes recorded lazily in the same way as their handlers do.
+ * Reads and writes of pages mapped with jit_map_page() access host
+ * memory directly, the others call the bus. A write to a byte covered
+ * by predecoded code (code_map) is reported to predecode_invalidate().
+ * All other instructions call their handler. Cycles are added to the
+ * counter before any access to the bus, so devices see the same clock
+ * as with execute(). After anything that may write, the block returns
+ * early when it has been invalidated, the run engine then continues one
+ * instruction at a time.
+ *
+ * Register use in generated code:
+ *	rbx	cpu
+ *	r12d	effective address
+ *	r13	code_map
+ *	r14d	byte to write, scratch
+ *	r15d	word to write
+ */
+
+#include "mc6809.hpp"
+
+#ifdef MC6809_JIT
+
+#include <cstring>
+#include <sys/mman.h>
+
+class mc6809_jit_emitter {
+public:
+	enum {
+		EAX = 0, ECX = 1, EDX = 2, EBX = 3, ESI = 6, EDI = 7,
+		R12 = 12, R13 = 13, R14 = 14, R15 = 15
+	};
+	enum { JE = 0x4, JNE = 0x5 };
+
+	uint8_t *code;
+
+	inline void b(uint8_t byte) { *code++ = byte; }
+	inline void w(uint16_t word) { memcpy(code, &word, 2); code += 2; }
+	inline void d(uint32_t dword) { memcpy(code, &dword, 4); code += 4; }
+	inline void q(uint64_t qword) { memcpy(code, &qword, 8); code += 8; }
+
+	/*
+	 * Prefix for 64 bit operands and / or registers r8-r15, only
+	 * emitted when needed
+	 */
+	inline void rex(bool wide, int reg, int rm)
+	{
+		uint8_t prefix = 0x40 | (wide ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((rm & 8) ? 0x01 : 0);
+		if (prefix != 0x40) b(prefix);
+	}
+	inline void mem(int reg, int32_t disp) { b(0x83 | ((reg & 7) << 3)); d(disp); }	// [rbx + disp32]
+	inline void reg(int reg, int rm) { b(0xc0 | ((reg & 7) << 3) | (rm & 7)); }
+
+	/*
+	 * Intel operand order, m is a member of the cpu ([rbx + m])
+	 */
+	inline void movzx8_rm(int r, int32_t m)  { rex(false, r, 0); b(0x0f); b(0xb6); mem(r, m); }
+	inline void movzx16_rm(int r, int32_t m) { rex(false, r, 0); b(0x0f); b(0xb7); mem(r, m); }
+	inline void movsx8_rm(int r, int32_t m)  { rex(false, r, 0); b(0x0f); b(0xbe); mem(r, m); }
+	inline void mov32_rm(int r, int32_t m)   { rex(false, r, 0); b(0x8b); mem(r, m); }
+	inline void mov64_rm(int r, int32_t m)   { rex(true, r, 0); b(0x8b); mem(r, m); }
+	inline void mov8_mr(int32_t m, int r)    { rex(false, r, 0); b(0x88); mem(r, m); }
+	inline void mov16_mr(int32_t m, int r)   { b(0x66); rex(false, r, 0); b(0x89); mem(r, m); }
+	inline void mov32_mr(int32_t m, int r)   { rex(false, r, 0); b(0x89); mem(r, m); }
+	inline void add16_mr(int32_t m, int r)   { b(0x66); rex(false, r, 0); b(0x01); mem(r, m); }
+	inline void mov8_mi(int32_t m, uint8_t i)   { b(0xc6); mem(0, m); b(i); }
+	inline void mov16_mi(int32_t m, uint16_t i) { b(0x66); b(0xc7); mem(0, m); w(i); }
+	inline void add32_mi(int32_t m, uint32_t i) { b(0x81); mem(0, m); d(i); }
+	inline void add16_mi(int32_t m, uint16_t i) { b(0x66); b(0x81); mem(0, m); w(i); }
+	inline void and8_mi(int32_t m, uint8_t i)   { b(0x80); mem(4, m); b(i); }
+	inline void or8_mi(int32_t m, uint8_t i)    { b(0x80); mem(1, m); b(i); }
+	inline void test8_mi(int32_t m, uint8_t i)  { b(0xf6); mem(0, m); b(i); }
+
+	/*
+	 * Register to register, op in its "r/m, r" form: add 0x01, or 0x09,
+	 * and 0x21, sub 0x29, xor 0x31, mov 0x89, test 0x85
+	 */
+	inline void op32_rr(uint8_t op, int dst, int src) { rex(false, src, dst); b(op); reg(src, dst); }
+	inline void op64_rr(uint8_t op, int dst, int src) { rex(true, src, dst); b(op); reg(src, dst); }
+	inline void op16_rr(uint8_t op, int dst, int src) { b(0x66); op32_rr(op, dst, src); }
+
+	/*
+	 * Register and immediate, ext selects the operation: add 0, or 1,
+	 * and 4, sub 5, xor 6, cmp 7
+	 */
+	inline void op32_ri(int ext, int r, uint32_t i) { rex(false, 0, r); b(0x81); reg(ext, r); d(i); }
+	inline void op16_ri(int ext, int r, uint16_t i) { b(0x66); rex(false, 0, r); b(0x81); reg(ext, r); w(i); }
+	inline void test8_ri(int r, uint8_t i) { rex(false, 0, r); b(0xf6); reg(0, r); b(i); }
+	inline void shl32_ri(int r, uint8_t n) { rex(false, 0, r); b(0xc1); reg(4, r); b(n); }
+	inline void shr32_ri(int r, uint8_t n) { rex(false, 0, r); b(0xc1); reg(5, r); b(n); }
+	inline void mov32_ri(int r, uint32_t i) { rex(false, 0, r); b(0xb8 | (r & 7)); d(i); }
+	inline void mov64_ri(int r, uint64_t i) { rex(true, 0, r); b(0xb8 | (r & 7)); q(i); }
+	inline void movzx8_rr(int dst, int src)  { rex(false, dst, src); b(0x0f); b(0xb6); reg(dst, src); }
+	inline void movzx16_rr(int dst, int src) { rex(false, dst, src); b(0x0f); b(0xb7); reg(dst, src); }
+
+	inline void push(int r) { rex(false, 0, r); b(0x50 | (r & 7)); }
+	inline void pop(int r)  { rex(false, 0, r); b(0x58 | (r & 7)); }
+	inline void call(uint64_t function) { mov64_ri(EAX, function); b(0xff); b(0xd0); }
+	inline void ret() { b(0xc3); }
+
+	/*
+	 * Forward jumps return the end of the jump, which is what bind()
+	 * needs to patch in the displacement to the current position.
+	 */
+	inline uint8_t *jcc8(uint8_t cc) { b(0x70 | cc); b(0); return code; }
+	inline uint8_t *jmp8() { b(0xeb); b(0); return code; }
+	inline void bind8(uint8_t *jump) { jump[-1] = (uint8_t)(code - jump); }
+	inline uint8_t *jcc32(uint8_t cc) { b(0x0f); b(0x80 | cc); d(0); return code; }
+	inline void bind32(uint8_t *jump) { int32_t rel = (int32_t)(code - jump); memcpy(jump - 4, &rel, 4); }
+	inline void jmp32(uint8_t *target) { b(0xe9); d((uint32_t)(int32_t)(target - (code + 4))); }
+};
+
+template <class bus_t>
+void mc6809_t<bus_t>::init_jit()
+{
+	jit = false;
+	jit_used = 0;
+	code_map = new bool[65536];
+	for (int i=0; i<65536; i++) code_map[i] = false;
+	for (int i=0; i<256; i++) {
+		jit_read_page[i] = nullptr;
+		jit_write_page[i] = nullptr;
+	}
+
+	/*
+	 * The buffer is never writable and executable at the same time,
+	 * jit_compile() only unprotects the pages it emits into.
+	 */
+	void *buffer = mmap(nullptr, MC6809_JIT_BUFFER, PROT_READ | PROT_EXEC,
+			    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	jit_buffer = (buffer == MAP_FAILED) ? nullptr : (uint8_t *)buffer;
+	if (!jit_buffer) printf("[MC6809] no executable memory, native code disabled\n");
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::cleanup_jit()
+{
+	if (jit_buffer) munmap(jit_buffer, MC6809_JIT_BUFFER);
+	delete [] code_map;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::jit_flush()
+{
+	for (int i=0; i<MC6809_BLOCK_POOL; i++) blocks[i].native = nullptr;
+	jit_used = 0;
+}
+
+/*
+ * Called from generated code
+ */
+template <class bus_t>
+uint8_t mc6809_t<bus_t>::jit_read(mc6809_t *cpu, uint16_t address)
+{
+	return cpu->read_8(address);
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::jit_write(mc6809_t *cpu, uint16_t address, uint8_t byte)
+{
+	cpu->write_8(address, byte);
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::jit_invalidate(mc6809_t *cpu, uint16_t address)
+{
+	cpu->predecode_invalidate(address);
+	// predecoded instructions at address and address - 1 are gone now
+	cpu->code_map[address] = cpu->block_covered[address];
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::jit_evaluate(mc6809_t *cpu)
+{
+	cpu->evaluate_flags();
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::jit_instruction(mc6809_t *cpu, predecoded_instruction *instruction)
+{
+	bool am_legal;
+	uint16_t effective_address = (cpu->*instruction->mode)(&am_legal);
+	(cpu->*instruction->handler)(effective_address);
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::jit_compile(translated_block *block)
+{
+	typedef mc6809_jit_emitter x86;
+
+	enum native_op {
+		NONE,
+		LD8, ST8, ADD8, SUB8, CMP8, AND8, OR8, EOR8, BIT8,	// value or address, a or b
+		LD16, ST16, CMP16, ADD16, SUB16,			// value or address, 16 bit register
+		INC, DEC, CLR, TST,					// address
+		INCR, DECR, CLRR, TSTR,					// a or b
+		LEA, ABX, NOP
+	};
+	enum native_reg { A, B, D, X, Y, U, S };
+
+	const struct {
+		execute_instruction handler;
+		native_op op;
+		native_reg reg;
+	} natives[] = {
+		{ &mc6809_t::lda,  LD8,   A }, { &mc6809_t::ldb,  LD8,   B },
+		{ &mc6809_t::sta,  ST8,   A }, { &mc6809_t::stb,  ST8,   B },
+		{ &mc6809_t::adda, ADD8,  A }, { &mc6809_t::addb, ADD8,  B },
+		{ &mc6809_t::suba, SUB8,  A }, { &mc6809_t::subb, SUB8,  B },
+		{ &mc6809_t::cmpa, CMP8,  A }, { &mc6809_t::cmpb, CMP8,  B },
+		{ &mc6809_t::anda, AND8,  A }, { &mc6809_t::andb, AND8,  B },
+		{ &mc6809_t::ora,  OR8,   A }, { &mc6809_t::orb,  OR8,   B },
+		{ &mc6809_t::eora, EOR8,  A }, { &mc6809_t::eorb, EOR8,  B },
+		{ &mc6809_t::bita, BIT8,  A }, { &mc6809_t::bitb, BIT8,  B },
+		{ &mc6809_t::ldd,  LD16,  D }, { &mc6809_t::ldx,  LD16,  X },
+		{ &mc6809_t::ldy,  LD16,  Y }, { &mc6809_t::ldu,  LD16,  U },
+		{ &mc6809_t::lds,  LD16,  S }, { &mc6809_t::std,  ST16,  D },
+		{ &mc6809_t::stx,  ST16,  X }, { &mc6809_t::sty,  ST16,  Y },
+		{ &mc6809_t::stu,  ST16,  U }, { &mc6809_t::sts,  ST16,  S },
+		{ &mc6809_t::cmpd, CMP16, D }, { &mc6809_t::cmpx, CMP16, X },
+		{ &mc6809_t::cmpy, CMP16, Y }, { &mc6809_t::cmpu, CMP16, U },
+		{ &mc6809_t::cmps, CMP16, S }, { &mc6809_t::addd, ADD16, D },
+		{ &mc6809_t::subd, SUB16, D },
+		{ &mc6809_t::inc,  INC,   A }, { &mc6809_t::dec,  DEC,   A },
+		{ &mc6809_t::clr,  CLR,   A }, { &mc6809_t::tst,  TST,   A },
+		{ &mc6809_t::inca, INCR,  A }, { &mc6809_t::incb, INCR,  B },
+		{ &mc6809_t::deca, DECR,  A }, { &mc6809_t::decb, DECR,  B },
+		{ &mc6809_t::clra, CLRR,  A }, { &mc6809_t::clrb, CLRR,  B },
+		{ &mc6809_t::tsta, TSTR,  A }, { &mc6809_t::tstb, TSTR,  B },
+		{ &mc6809_t::leax, LEA,   X }, { &mc6809_t::leay, LEA,   Y },
+		{ &mc6809_t::leau, LEA,   U }, { &mc6809_t::leas, LEA,   S },
+		{ &mc6809_t::abx,  ABX,   X }, { &mc6809_t::nop,  NOP,   A }
+	};
+
+	auto offset = [this](void *member) { return (int32_t)((uint8_t *)member - (uint8_t *)this); };
+	const int32_t reg_offsets[] = {
+		offset(&ac), offset(&br), 0, offset(&xr), offset(&yr), offset(&us), offset(&sp)
+	};
+	const int32_t o_pc = offset(&pc);
+	const int32_t o_dp = offset(&dp);
+	const int32_t o_ac = offset(&ac);
+	const int32_t o_br = offset(&br);
+	const int32_t o_cc = offset(&cc);
+	const int32_t o_lazy_kind = offset(&lazy_kind);
+	const int32_t o_lazy_mask = offset(&lazy_mask);
+	const int32_t o_lazy_op1 = offset(&lazy_op1);
+	const int32_t o_lazy_op2 = offset(&lazy_op2);
+	const int32_t o_lazy_result = offset(&lazy_result);
+	const int32_t o_cycles = offset(&cycles);
+	const int32_t o_generation = offset(&predecode_generation);
+	const int32_t o_nmi_enabled = offset(&nmi_enabled);
+	const int32_t o_read_page = offset(&jit_read_page[0]);
+	const int32_t o_write_page = offset(&jit_write_page[0]);
+	const int32_t o_code_map = offset(&code_map);
+
+	if ((MC6809_JIT_BUFFER - jit_used) < MC6809_JIT_BLOCK_SIZE) jit_flush();
+
+	uint8_t *pages = &jit_buffer[jit_used & ~(MC6809_JIT_PAGE - 1)];
+	size_t pages_size = ((jit_used + MC6809_JIT_BLOCK_SIZE + MC6809_JIT_PAGE - 1) &
+			     ~(MC6809_JIT_PAGE - 1)) - (pages - jit_buffer);
+	if (mprotect(pages, pages_size, PROT_READ | PROT_WRITE)) return;
+
+	x86 e;
+	e.code = &jit_buffer[jit_used];
+	uint8_t *entry = e.code;
+
+	uint32_t pending = 0;	// cycles not yet added to the counter
+	int known = -1;		// lazy_mask, if known when compiling
+
+	struct {
+		uint8_t *jump;
+		uint16_t pc;
+		bool set_pc;
+		uint8_t executed;
+	} exits[MC6809_BLOCK_INSTRUCTIONS];
+	int no_of_exits = 0;
+
+	auto flush_cycles = [&]() {
+		if (pending) e.add32_mi(o_cycles, pending);
+		pending = 0;
+	};
+
+	auto call_cpu = [&](uint64_t function) {
+		e.op64_rr(0x89, x86::EDI, x86::EBX);
+		e.call(function);
+	};
+
+	// eax = byte at r12d
+	auto read_byte = [&]() {
+		e.op32_rr(0x89, x86::ECX, x86::R12);
+		e.shr32_ri(x86::ECX, 8);
+		e.b(0x48); e.b(0x8b); e.b(0x94); e.b(0xcb); e.d(o_read_page);	// mov rdx, [rbx + rcx * 8 + page]
+		e.op64_rr(0x85, x86::EDX, x86::EDX);
+		uint8_t *slow = e.jcc8(x86::JE);
+		e.movzx8_rr(x86::ECX, x86::R12);
+		e.b(0x0f); e.b(0xb6); e.b(0x04); e.b(0x0a);			// movzx eax, byte [rdx + rcx]
+		uint8_t *done = e.jmp8();
+		e.bind8(slow);
+		e.op32_rr(0x89, x86::ESI, x86::R12);
+		call_cpu((uint64_t)&mc6809_t::jit_read);
+		e.movzx8_rr(x86::EAX, x86::EAX);
+		e.bind8(done);
+	};
+
+	// eax = word at r12d, r12d points to its second byte
+	auto read_word = [&]() {
+		read_byte();
+		e.op32_rr(0x89, x86::R14, x86::EAX);
+		e.shl32_ri(x86::R14, 8);
+		e.op16_ri(0, x86::R12, 1);
+		read_byte();
+		e.op32_rr(0x09, x86::EAX, x86::R14);
+	};
+
+	// byte at r12d = r14b
+	auto write_byte = [&]() {
+		e.op32_rr(0x89, x86::ECX, x86::R12);
+		e.shr32_ri(x86::ECX, 8);
+		e.b(0x48); e.b(0x8b); e.b(0x94); e.b(0xcb); e.d(o_write_page);	// mov rdx, [rbx + rcx * 8 + page]
+		e.op64_rr(0x85, x86::EDX, x86::EDX);
+		uint8_t *slow = e.jcc8(x86::JE);
+		e.movzx8_rr(x86::ECX, x86::R12);
+		e.b(0x44); e.b(0x88); e.b(0x34); e.b(0x0a);			// mov [rdx + rcx], r14b
+		e.movzx16_rr(x86::ECX, x86::R12);
+		e.b(0x41); e.b(0x80); e.b(0x7c); e.b(0x0d); e.b(0x00); e.b(0x00);	// cmp byte [r13 + rcx], 0
+		uint8_t *data = e.jcc8(x86::JE);
+		e.op32_rr(0x89, x86::ESI, x86::R12);
+		call_cpu((uint64_t)&mc6809_t::jit_invalidate);
+		uint8_t *done = e.jmp8();
+		e.bind8(slow);
+		e.op32_rr(0x89, x86::ESI, x86::R12);
+		e.op32_rr(0x89, x86::EDX, x86::R14);
+		call_cpu((uint64_t)&mc6809_t::jit_write);
+		e.bind8(data);
+		e.bind8(done);
+	};
+
+	/*
+	 * Evaluates pending flags that the next operation won't replace,
+	 * as lazy_flags() does. Done before its operands are computed, as
+	 * evaluation uses the scratch registers.
+	 */
+	auto prepare_flags = [&](uint8_t mask) {
+		if (known < 0) {
+			e.test8_mi(o_lazy_mask, (uint8_t)~mask);
+			uint8_t *skip = e.jcc8(x86::JE);
+			call_cpu((uint64_t)&mc6809_t::jit_evaluate);
+			e.bind8(skip);
+		} else if (known & ~mask) {
+			call_cpu((uint64_t)&mc6809_t::jit_evaluate);
+		}
+	};
+
+	// op1 / op2 are registers, or immediates when negative (-1 - value)
+	auto store_flags = [&](uint8_t kind, uint8_t mask, int op1, int op2, int result) {
+		e.mov8_mi(o_lazy_kind, kind);
+		e.mov8_mi(o_lazy_mask, mask);
+		if (op1 >= 0) e.mov16_mr(o_lazy_op1, op1); else e.mov16_mi(o_lazy_op1, (uint16_t)(-1 - op1));
+		if (op2 >= 0) e.mov16_mr(o_lazy_op2, op2); else e.mov16_mi(o_lazy_op2, (uint16_t)(-1 - op2));
+		e.mov32_mr(o_lazy_result, result);
+		known = mask;
+	};
+
+	auto store_logic = [&](uint8_t kind, int result) {
+		// operands aren't used for logic results
+		e.mov8_mi(o_lazy_kind, kind);
+		e.mov8_mi(o_lazy_mask, N_FLAG|Z_FLAG|V_FLAG);
+		e.mov32_mr(o_lazy_result, result);
+		known = N_FLAG|Z_FLAG|V_FLAG;
+	};
+
+	// r = d
+	auto load_d = [&](int r, int scratch) {
+		e.movzx8_rm(r, o_ac);
+		e.shl32_ri(r, 8);
+		e.movzx8_rm(scratch, o_br);
+		e.op32_rr(0x09, r, scratch);
+	};
+
+	// d = r, destroys r
+	auto store_d = [&](int r) {
+		e.mov8_mr(o_br, r);
+		e.shr32_ri(r, 8);
+		e.mov8_mr(o_ac, r);
+	};
+
+	/*
+	 * Leaves the block when an instruction invalidated it
+	 */
+	auto check_block = [&](uint16_t next, bool set_pc, int executed) {
+		e.mov32_rm(x86::EAX, o_generation);
+		e.mov64_ri(x86::ECX, (uint64_t)&block->generation);
+		e.b(0x3b); e.b(0x01);						// cmp eax, [rcx]
+		exits[no_of_exits].jump = e.jcc32(x86::JNE);
+		exits[no_of_exits].pc = next;
+		exits[no_of_exits].set_pc = set_pc;
+		exits[no_of_exits].executed = executed;
+		no_of_exits++;
+	};
+
+	e.push(x86::EBX);
+	e.push(x86::R12);
+	e.push(x86::R13);
+	e.push(x86::R14);
+	e.push(x86::R15);
+	e.op64_rr(0x89, x86::EBX, x86::EDI);
+	e.mov64_rm(x86::R13, o_code_map);
+
+	uint16_t address = block->start;
+	bool last_native = false;
+	uint16_t next = address;
+
+	for (int i=0; i<block->no_of_instructions; i++) {
+		predecoded_instruction *instruction = &block->instructions[i];
+		uint16_t operand = address + instruction->length;
+		next = operand + operand_length(operand, instruction);
+		address = next;
+
+		native_op op = NONE;
+		native_reg reg = A;
+		for (unsigned int j=0; j<(sizeof(natives)/sizeof(natives[0])); j++) {
+			if (instruction->handler == natives[j].handler) {
+				op = natives[j].op;
+				reg = natives[j].reg;
+			}
+		}
+
+		/*
+		 * Check the addressing mode and find the extra cycles of
+		 * indexed modes. Illegal postbytes are left to the handler.
+		 */
+		bool immediate = (instruction->mode == &mc6809_t::a_imb) || (instruction->mode == &mc6809_t::a_imw);
+		bool inherent = (instruction->mode == &mc6809_t::a_ih);
+		bool indexed = (instruction->mode == &mc6809_t::a_idx);
+		bool memory = indexed || (instruction->mode == &mc6809_t::a_dir) ||
+			(instruction->mode == &mc6809_t::a_ext);
+		uint8_t postbyte = indexed ? read_8(operand) : 0;
+		int extra = 0;
+
+		if (indexed) {
+			static const int8_t direct_cycles[16] = {
+				2, 3, 2, 3, 0, 1, 1, -1, 1, 4, -1, 4, 1, 5, -1, -1
+			};
+			static const int8_t indirect_cycles[16] = {
+				-1, 6, -1, 6, 3, 4, 4, -1, 4, 7, -1, 7, 4, 8, -1, -1
+			};
+			if (postbyte == 0b10011111) {
+				extra = 5;
+			} else if (!(postbyte & 0b10000000)) {
+				extra = 1;
+			} else if (postbyte & 0b00010000) {
+				extra = indirect_cycles[postbyte & 0x0f];
+			} else {
+				extra = direct_cycles[postbyte & 0x0f];
+			}
+			if (extra < 0) op = NONE;
+		}
+
+		switch (op) {
+			case LD8: case ADD8: case SUB8: case CMP8: case AND8:
+			case OR8: case EOR8: case BIT8: case LD16: case CMP16:
+			case ADD16: case SUB16:
+				if (!immediate && !memory) op = NONE;
+				break;
+			case ST8: case ST16: case INC: case DEC: case CLR: case TST:
+				if (!memory) op = NONE;
+				break;
+			case LEA:
+				if (!indexed) op = NONE;
+				break;
+			case INCR: case DECR: case CLRR: case TSTR: case ABX: case NOP:
+				if (!inherent) op = NONE;
+				break;
+			case NONE:
+				break;
+		}
+
+		last_native = (op != NONE);
+
+		if (op == NONE) {
+			/*
+			 * The handler does the work, including the cycles of
+			 * its addressing mode. Anything can change.
+			 */
+			pending += instruction->cycles;
+			flush_cycles();
+			e.mov16_mi(o_pc, operand);
+			e.op64_rr(0x89, x86::EDI, x86::EBX);
+			e.mov64_ri(x86::ESI, (uint64_t)instruction);
+			e.call((uint64_t)&mc6809_t::jit_instruction);
+			known = -1;
+			if (i != block->no_of_instructions - 1) check_block(next, false, i + 1);
+			continue;
+		}
+
+		pending += instruction->cycles + extra;
+		if (memory) flush_cycles();
+
+		/*
+		 * Flags first, the other instructions only clear bits in
+		 * lazy_mask
+		 */
+		switch (op) {
+			case LD8: case ST8: case AND8: case OR8: case EOR8: case TST: case TSTR:
+			case LD16: case ST16:
+				prepare_flags(N_FLAG|Z_FLAG|V_FLAG);
+				break;
+			case ADD8:
+				prepare_flags(H_FLAG|N_FLAG|Z_FLAG|V_FLAG|C_FLAG);
+				break;
+			case SUB8: case CMP8: case CLR: case CLRR:
+			case CMP16: case ADD16: case SUB16:
+				prepare_flags(N_FLAG|Z_FLAG|V_FLAG|C_FLAG);
+				break;
+			case INC: case DEC: case INCR: case DECR:
+				prepare_flags(N_FLAG|Z_FLAG|V_FLAG);
+				break;
+			default:
+				break;
+		}
+
+		/*
+		 * Effective address into r12d
+		 */
+		if (instruction->mode == &mc6809_t::a_dir) {
+			e.movzx8_rm(x86::R12, o_dp);
+			e.shl32_ri(x86::R12, 8);
+			e.op32_ri(1, x86::R12, read_8(operand));
+		} else if (instruction->mode == &mc6809_t::a_ext) {
+			e.mov32_ri(x86::R12, (read_8(operand) << 8) | read_8(operand + 1));
+		} else if (indexed) {
+			int32_t index = offset(index_regs[(postbyte & 0b01100000) >> 5]);
+			uint16_t displacement = 0;
+
+			if (postbyte == 0b10011111) {
+				e.mov32_ri(x86::R12, (read_8(operand + 1) << 8) | read_8(operand + 2));
+			} else if (!(postbyte & 0b10000000)) {
+				e.movzx16_rm(x86::R12, index);
+				displacement = (postbyte & 0b00010000) ? (0xffe0 | (postbyte & 0x1f)) : (postbyte & 0x0f);
+			} else {
+				switch (postbyte & 0b00001111) {
+					case 0b0000:
+						e.movzx16_rm(x86::R12, index);
+						e.add16_mi(index, 1);
+						break;
+					case 0b0001:
+						e.movzx16_rm(x86::R12, index);
+						e.add16_mi(index, 2);
+						break;
+					case 0b0010:
+						e.add16_mi(index, 0xffff);
+						e.movzx16_rm(x86::R12, index);
+						break;
+					case 0b0011:
+						e.add16_mi(index, 0xfffe);
+						e.movzx16_rm(x86::R12, index);
+						break;
+					case 0b0100:
+						e.movzx16_rm(x86::R12, index);
+						break;
+					case 0b0101:
+						e.movzx16_rm(x86::R12, index);
+						e.movsx8_rm(x86::EAX, o_br);
+						e.op16_rr(0x01, x86::R12, x86::EAX);
+						break;
+					case 0b0110:
+						e.movzx16_rm(x86::R12, index);
+						e.movsx8_rm(x86::EAX, o_ac);
+						e.op16_rr(0x01, x86::R12, x86::EAX);
+						break;
+					case 0b1000:
+						e.movzx16_rm(x86::R12, index);
+						displacement = (int8_t)read_8(operand + 1);
+						break;
+					case 0b1001:
+						e.movzx16_rm(x86::R12, index);
+						displacement = (read_8(operand + 1) << 8) | read_8(operand + 2);
+						break;
+					case 0b1011:
+						e.movzx16_rm(x86::R12, index);
+						load_d(x86::EAX, x86::ECX);
+						e.op16_rr(0x01, x86::R12, x86::EAX);
+						break;
+					case 0b1100:
+						e.mov32_ri(x86::R12, (uint16_t)(next + (int8_t)read_8(operand + 1)));
+						break;
+					case 0b1101:
+						e.mov32_ri(x86::R12, (uint16_t)(next + ((read_8(operand + 1) << 8) | read_8(operand + 2))));
+						break;
+				}
+			}
+			if (displacement) e.op16_ri(0, x86::R12, displacement);
+			if ((postbyte & 0b10010000) == 0b10010000) {
+				read_word();
+				e.op32_rr(0x89, x86::R12, x86::EAX);
+			}
+		}
+
+		/*
+		 * Operand into eax
+		 */
+		switch (op) {
+			case LD8: case ADD8: case SUB8: case CMP8: case AND8:
+			case OR8: case EOR8: case BIT8: case INC: case DEC: case TST:
+				if (immediate) {
+					e.mov32_ri(x86::EAX, read_8(operand));
+				} else {
+					read_byte();
+				}
+				break;
+			case LD16: case CMP16: case ADD16: case SUB16:
+				if (immediate) {
+					e.mov32_ri(x86::EAX, (read_8(operand) << 8) | read_8(operand + 1));
+				} else {
+					read_word();
+				}
+				break;
+			default:
+				break;
+		}
+
+		int32_t r = reg_offsets[reg];
+
+		switch (op) {
+			case LD8:
+				e.mov8_mr(r, x86::EAX);
+				store_logic(LAZY_LOGIC_8, x86::EAX);
+				break;
+			case ST8:
+				e.movzx8_rm(x86::R14, r);
+				write_byte();
+				store_logic(LAZY_LOGIC_8, x86::R14);
+				break;
+			case ADD8:
+				e.movzx8_rm(x86::ECX, r);
+				e.op32_rr(0x89, x86::EDX, x86::ECX);
+				e.op32_rr(0x01, x86::EDX, x86::EAX);
+				e.mov8_mr(r, x86::EDX);
+				store_flags(LAZY_ADD_8, H_FLAG|N_FLAG|Z_FLAG|V_FLAG|C_FLAG, x86::ECX, x86::EAX, x86::EDX);
+				break;
+			case SUB8:
+			case CMP8:
+				e.movzx8_rm(x86::ECX, r);
+				e.op32_rr(0x89, x86::EDX, x86::ECX);
+				e.op32_rr(0x29, x86::EDX, x86::EAX);
+				e.op32_ri(4, x86::EDX, 0xffff);
+				if (op == SUB8) e.mov8_mr(r, x86::EDX);
+				store_flags(LAZY_SUB_8, N_FLAG|Z_FLAG|V_FLAG|C_FLAG, x86::ECX, x86::EAX, x86::EDX);
+				break;
+			case AND8:
+			case OR8:
+			case EOR8:
+				e.movzx8_rm(x86::ECX, r);
+				e.op32_rr((op == AND8) ? 0x21 : (op == OR8) ? 0x09 : 0x31, x86::ECX, x86::EAX);
+				e.mov8_mr(r, x86::ECX);
+				store_logic(LAZY_LOGIC_8, x86::ECX);
+				break;
+			case BIT8:
+			{
+				// flags set directly, like the handler does
+				e.movzx8_rm(x86::ECX, r);
+				e.op32_rr(0x21, x86::ECX, x86::EAX);
+				e.and8_mi(o_lazy_mask, (uint8_t)~(N_FLAG|Z_FLAG|V_FLAG));
+				e.movzx8_rm(x86::EAX, o_cc);
+				e.op32_ri(4, x86::EAX, (uint8_t)~(N_FLAG|Z_FLAG|V_FLAG));
+				e.test8_ri(x86::ECX, 0xff);
+				uint8_t *nonzero = e.jcc8(x86::JNE);
+				e.op32_ri(1, x86::EAX, Z_FLAG);
+				e.bind8(nonzero);
+				e.test8_ri(x86::ECX, 0x80);
+				uint8_t *positive = e.jcc8(x86::JE);
+				e.op32_ri(1, x86::EAX, N_FLAG);
+				e.bind8(positive);
+				e.mov8_mr(o_cc, x86::EAX);
+				if (known >= 0) known &= ~(N_FLAG|Z_FLAG|V_FLAG);
+				break;
+			}
+			case LD16:
+				if (reg == D) {
+					e.op32_rr(0x89, x86::ECX, x86::EAX);
+					store_d(x86::ECX);
+				} else {
+					e.mov16_mr(r, x86::EAX);
+				}
+				if (reg == S) e.mov8_mi(o_nmi_enabled, 1);
+				store_logic(LAZY_LOGIC_16, x86::EAX);
+				break;
+			case ST16:
+				if (reg == D) {
+					load_d(x86::R15, x86::EAX);
+				} else {
+					e.movzx16_rm(x86::R15, r);
+				}
+				e.op32_rr(0x89, x86::R14, x86::R15);
+				e.shr32_ri(x86::R14, 8);
+				write_byte();
+				e.op16_ri(0, x86::R12, 1);
+				e.op32_rr(0x89, x86::R14, x86::R15);
+				write_byte();
+				store_logic(LAZY_LOGIC_16, x86::R15);
+				break;
+			case CMP16:
+			case ADD16:
+			case SUB16:
+				if (reg == D) {
+					load_d(x86::ECX, x86::EDX);
+				} else {
+					e.movzx16_rm(x86::ECX, r);
+				}
+				e.op32_rr(0x89, x86::EDX, x86::ECX);
+				e.op32_rr((op == ADD16) ? 0x01 : 0x29, x86::EDX, x86::EAX);
+				store_flags((op == ADD16) ? LAZY_ADD_16 : LAZY_SUB_16,
+					    N_FLAG|Z_FLAG|V_FLAG|C_FLAG, x86::ECX, x86::EAX, x86::EDX);
+				if (op != CMP16) store_d(x86::EDX);
+				break;
+			case INC:
+			case DEC:
+				e.op32_rr(0x89, x86::ECX, x86::EAX);
+				e.op32_rr(0x89, x86::R14, x86::EAX);
+				e.op32_ri(0, x86::R14, (op == INC) ? 0x01 : 0xff);
+				store_flags(LAZY_ADD_8, N_FLAG|Z_FLAG|V_FLAG, x86::ECX, -1 - ((op == INC) ? 0x01 : 0xff), x86::R14);
+				write_byte();
+				break;
+			case CLR:
+				e.mov32_ri(x86::R14, 0);
+				write_byte();
+				e.mov32_ri(x86::EAX, 0);
+				store_flags(LAZY_SUB_8, N_FLAG|Z_FLAG|V_FLAG|C_FLAG, -1, -1, x86::EAX);
+				break;
+			case TST:
+				store_logic(LAZY_LOGIC_8, x86::EAX);
+				break;
+			case INCR:
+			case DECR:
+				e.movzx8_rm(x86::ECX, r);
+				e.op32_rr(0x89, x86::EDX, x86::ECX);
+				e.op32_ri(0, x86::EDX, (op == INCR) ? 0x01 : 0xff);
+				e.mov8_mr(r, x86::EDX);
+				store_flags(LAZY_ADD_8, N_FLAG|Z_FLAG|V_FLAG, x86::ECX, -1 - ((op == INCR) ? 0x01 : 0xff), x86::EDX);
+				break;
+			case CLRR:
+				e.mov8_mi(r, 0);
+				e.mov32_ri(x86::EAX, 0);
+				store_flags(LAZY_SUB_8, N_FLAG|Z_FLAG|V_FLAG|C_FLAG, -1, -1, x86::EAX);
+				break;
+			case TSTR:
+				e.movzx8_rm(x86::EAX, r);
+				store_logic(LAZY_LOGIC_8, x86::EAX);
+				break;
+			case LEA:
+			{
+				e.and8_mi(o_lazy_mask, (uint8_t)~Z_FLAG);
+				e.and8_mi(o_cc, (uint8_t)~Z_FLAG);
+				e.op32_rr(0x85, x86::R12, x86::R12);
+				uint8_t *nonzero = e.jcc8(x86::JNE);
+				e.or8_mi(o_cc, Z_FLAG);
+				e.bind8(nonzero);
+				e.mov16_mr(r, x86::R12);
+				if (reg == S) e.mov8_mi(o_nmi_enabled, 1);
+				if (known >= 0) known &= ~Z_FLAG;
+				break;
+			}
+			case ABX:
+				e.movzx8_rm(x86::EAX, o_br);
+				e.add16_mr(r, x86::EAX);
+				break;
+			default:
+				break;
+		}
+
+		bool writes = (op == ST8) || (op == ST16) || (op == INC) || (op == DEC) || (op == CLR);
+		if (writes && (i != block->no_of_instructions - 1)) check_block(next, true, i + 1);
+	}
+
+	flush_cycles();
+	if (last_native) e.mov16_mi(o_pc, next);
+	e.mov32_ri(x86::EAX, block->no_of_instructions);
+	uint8_t *epilogue = e.code;
+	e.pop(x86::R15);
+	e.pop(x86::R14);
+	e.pop(x86::R13);
+	e.pop(x86::R12);
+	e.pop(x86::EBX);
+	e.ret();
+
+	for (int i=0; i<no_of_exits; i++) {
+		e.bind32(exits[i].jump);
+		if (exits[i].set_pc) e.mov16_mi(o_pc, exits[i].pc);
+		e.mov32_ri(x86::EAX, exits[i].executed);
+		e.jmp32(epilogue);
+	}
+
+	jit_used += e.code - entry;
+	if (mprotect(pages, pages_size, PROT_READ | PROT_EXEC)) {
+		printf("[MC6809] can't protect native code, native code disabled\n");
+		jit = false;
+		return;
+	}
+	block->native = (native_block)entry;
+}
+
+#else
+
+template <class bus_t>
+void mc6809_t<bus_t>::init_jit()
+{
+	jit = false;
+	jit_buffer = nullptr;
+	jit_used = 0;
+	code_map = new bool[65536];
+	for (int i=0; i<65536; i++) code_map[i] = false;
+	for (int i=0; i<256; i++) {
+		jit_read_page[i] = nullptr;
+		jit_write_page[i] = nullptr;
+	}
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::cleanup_jit()
+{
+	delete [] code_map;
+}
+
+#endif
@@ -0,0 +1,799 @@
+/*
+ * mc6809_run_cpp.hpp  -  part of MC6809
+ *
+ * (C)2021-2022 elmerucr
+ */
+
+/*
+ * Block execution engine. Runs instructions until at least the requested
+ * number of cycles has been consumed or a breakpoint is reached. Dispatch
+ * is done on the index of the predecoded instruction, using labels as
+ * values (direct threading) on GCC and Clang, and a switch elsewhere.
+ * Handlers and cycle counts are shared with execute(), so both engines
+ * produce identical results.
+ *
+ * Addresses that often start a straight run of code (jump targets, code
+ * after a branch or an interrupt) get translated into a block. A block
+ * is only entered when the remaining budget can't run out before its last
+ * instruction, so it runs without checks for interrupts, budget and
+ * breakpoints. Only the validity of the block is checked after each
+ * instruction, as it may modify itself. In between, the interrupt lines
+ * are only looked at when the attention line is up. Blocks that keep
+ * being entered are compiled into native code where supported (see
+ * mc6809_jit_cpp.hpp), under the same conditions.
+ *
+ * Waiting after cwai or sync, or spinning in an idle loop (a block that
+ * only reads memory pages and branches back to itself) can't end before
+ * a device changes something, which only happens in between runs. Waiting
+ * consumes the remainder of the budget at once, an idle loop skips as
+ * many whole passes as fit. Loops reading i/o pages only skip while the
+ * embedder declares those reads free of side effects.
+ */
+
+#include "mc6809.hpp"
+
+#if defined(__GNUC__)
+#define MC6809_THREADED_DISPATCH
+#endif
+
+#ifdef MC6809_THREADED_DISPATCH
+#define DISPATCH(index)		goto *dispatch_table[index];
+#define LABEL(index)		op_##index
+#else
+#define DISPATCH(index)		switch (index)
+#define LABEL(index)		case index
+#endif
+
+/*
+ * Inherent mode has no side effects and its result isn't used
+ */
+#define OP(index, mode, instruction) \
+	LABEL(index): instruction(mode(&am_legal)); goto next;
+#define OP_IH(index, instruction) \
+	LABEL(index): instruction(0); goto next;
+
+template <class bus_t>
+uint32_t mc6809_t<bus_t>::run(uint32_t no_of_cycles)
+{
+#ifdef MC6809_THREADED_DISPATCH
+	static const void *dispatch_table[768] = {
+		&&op_0x000,	&&op_ill,	&&op_ill,	&&op_0x003,	&&op_0x004,	&&op_ill,	&&op_0x006,	&&op_0x007,	// 0x000
+		&&op_0x008,	&&op_0x009,	&&op_0x00a,	&&op_ill,	&&op_0x00c,	&&op_0x00d,	&&op_0x00e,	&&op_0x00f,
+		&&op_0x010,	&&op_0x011,	&&op_0x012,	&&op_0x013,	&&op_ill,	&&op_ill,	&&op_0x016,	&&op_0x017,	// 0x010
+		&&op_ill,	&&op_0x019,	&&op_0x01a,	&&op_ill,	&&op_0x01c,	&&op_0x01d,	&&op_0x01e,	&&op_0x01f,
+		&&op_0x020,	&&op_0x021,	&&op_0x022,	&&op_0x023,	&&op_0x024,	&&op_0x025,	&&op_0x026,	&&op_0x027,	// 0x020
+		&&op_0x028,	&&op_0x029,	&&op_0x02a,	&&op_0x02b,	&&op_0x02c,	&&op_0x02d,	&&op_0x02e,	&&op_0x02f,
+		&&op_0x030,	&&op_0x031,	&&op_0x032,	&&op_0x033,	&&op_0x034,	&&op_0x035,	&&op_0x036,	&&op_0x037,	// 0x030
+		&&op_ill,	&&op_0x039,	&&op_0x03a,	&&op_0x03b,	&&op_0x03c,	&&op_0x03d,	&&op_ill,	&&op_0x03f,
+		&&op_0x040,	&&op_ill,	&&op_ill,	&&op_0x043,	&&op_0x044,	&&op_ill,	&&op_0x046,	&&op_0x047,	// 0x040
+		&&op_0x048,	&&op_0x049,	&&op_0x04a,	&&op_ill,	&&op_0x04c,	&&op_0x04d,	&&op_ill,	&&op_0x04f,
+		&&op_0x050,	&&op_ill,	&&op_ill,	&&op_0x053,	&&op_0x054,	&&op_ill,	&&op_0x056,	&&op_0x057,	// 0x050
+		&&op_0x058,	&&op_0x059,	&&op_0x05a,	&&op_ill,	&&op_0x05c,	&&op_0x05d,	&&op_ill,	&&op_0x05f,
+		&&op_0x060,	&&op_ill,	&&op_ill,	&&op_0x063,	&&op_0x064,	&&op_ill,	&&op_0x066,	&&op_0x067,	// 0x060
+		&&op_0x068,	&&op_0x069,	&&op_0x06a,	&&op_ill,	&&op_0x06c,	&&op_0x06d,	&&op_0x06e,	&&op_0x06f,
+		&&op_0x070,	&&op_ill,	&&op_ill,	&&op_0x073,	&&op_0x074,	&&op_ill,	&&op_0x076,	&&op_0x077,	// 0x070
+		&&op_0x078,	&&op_0x079,	&&op_0x07a,	&&op_ill,	&&op_0x07c,	&&op_0x07d,	&&op_0x07e,	&&op_0x07f,
+		&&op_0x080,	&&op_0x081,	&&op_0x082,	&&op_0x083,	&&op_0x084,	&&op_0x085,	&&op_0x086,	&&op_ill,	// 0x080
+		&&op_0x088,	&&op_0x089,	&&op_0x08a,	&&op_0x08b,	&&op_0x08c,	&&op_0x08d,	&&op_0x08e,	&&op_ill,
+		&&op_0x090,	&&op_0x091,	&&op_0x092,	&&op_0x093,	&&op_0x094,	&&op_0x095,	&&op_0x096,	&&op_0x097,	// 0x090
+		&&op_0x098,	&&op_0x099,	&&op_0x09a,	&&op_0x09b,	&&op_0x09c,	&&op_0x09d,	&&op_0x09e,	&&op_0x09f,
+		&&op_0x0a0,	&&op_0x0a1,	&&op_0x0a2,	&&op_0x0a3,	&&op_0x0a4,	&&op_0x0a5,	&&op_0x0a6,	&&op_0x0a7,	// 0x0a0
+		&&op_0x0a8,	&&op_0x0a9,	&&op_0x0aa,	&&op_0x0ab,	&&op_0x0ac,	&&op_0x0ad,	&&op_0x0ae,	&&op_0x0af,
+		&&op_0x0b0,	&&op_0x0b1,	&&op_0x0b2,	&&op_0x0b3,	&&op_0x0b4,	&&op_0x0b5,	&&op_0x0b6,	&&op_0x0b7,	// 0x0b0
+		&&op_0x0b8,	&&op_0x0b9,	&&op_0x0ba,	&&op_0x0bb,	&&op_0x0bc,	&&op_0x0bd,	&&op_0x0be,	&&op_0x0bf,
+		&&op_0x0c0,	&&op_0x0c1,	&&op_0x0c2,	&&op_0x0c3,	&&op_0x0c4,	&&op_0x0c5,	&&op_0x0c6,	&&op_ill,	// 0x0c0
+		&&op_0x0c8,	&&op_0x0c9,	&&op_0x0ca,	&&op_0x0cb,	&&op_0x0cc,	&&op_ill,	&&op_0x0ce,	&&op_ill,
+		&&op_0x0d0,	&&op_0x0d1,	&&op_0x0d2,	&&op_0x0d3,	&&op_0x0d4,	&&op_0x0d5,	&&op_0x0d6,	&&op_0x0d7,	// 0x0d0
+		&&op_0x0d8,	&&op_0x0d9,	&&op_0x0da,	&&op_0x0db,	&&op_0x0dc,	&&op_0x0dd,	&&op_0x0de,	&&op_0x0df,
+		&&op_0x0e0,	&&op_0x0e1,	&&op_0x0e2,	&&op_0x0e3,	&&op_0x0e4,	&&op_0x0e5,	&&op_0x0e6,	&&op_0x0e7,	// 0x0e0
+		&&op_0x0e8,	&&op_0x0e9,	&&op_0x0ea,	&&op_0x0eb,	&&op_0x0ec,	&&op_0x0ed,	&&op_0x0ee,	&&op_0x0ef,
+		&&op_0x0f0,	&&op_0x0f1,	&&op_0x0f2,	&&op_0x0f3,	&&op_0x0f4,	&&op_0x0f5,	&&op_0x0f6,	&&op_0x0f7,	// 0x0f0
+		&&op_0x0f8,	&&op_0x0f9,	&&op_0x0fa,	&&op_0x0fb,	&&op_0x0fc,	&&op_0x0fd,	&&op_0x0fe,	&&op_0x0ff,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x100
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x110
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_0x121,	&&op_0x122,	&&op_0x123,	&&op_0x124,	&&op_0x125,	&&op_0x126,	&&op_0x127,	// 0x120
+		&&op_0x128,	&&op_0x129,	&&op_0x12a,	&&op_0x12b,	&&op_0x12c,	&&op_0x12d,	&&op_0x12e,	&&op_0x12f,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x130
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x13f,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x140
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x150
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x160
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x170
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x183,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x180
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x18c,	&&op_ill,	&&op_0x18e,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x193,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x190
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x19c,	&&op_ill,	&&op_0x19e,	&&op_0x19f,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x1a3,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x1a0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x1ac,	&&op_ill,	&&op_0x1ae,	&&op_0x1af,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x1b3,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x1b0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x1bc,	&&op_ill,	&&op_0x1be,	&&op_0x1bf,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x1c0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x1ce,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x1d0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x1de,	&&op_0x1df,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x1e0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x1ee,	&&op_0x1ef,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x1f0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x1fe,	&&op_0x1ff,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x200
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x210
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x220
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x230
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x23f,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x240
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x250
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x260
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x270
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x283,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x280
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x28c,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x293,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x290
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x29c,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x2a3,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x2a0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x2ac,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x2b3,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x2b0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_0x2bc,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x2c0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x2d0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x2e0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	// 0x2f0
+		&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill,	&&op_ill
+	};
+#endif
+
+	uint32_t start_cycles = cycles;
+	run_end = cycles + no_of_cycles;
+	translated_block *block = blocks;
+	predecoded_instruction *instruction;
+	predecoded_instruction *last_instruction;
+	bool block_head = true;
+	bool am_legal;
+	translated_block *idle_block = nullptr;
+	uint32_t idle_start = 0;
+
+	do {
+		if (interrupt()) {
+			block_head = true;
+			idle_block = nullptr;
+		} else if (waiting()) {
+			/*
+			 * Halted by cwai or sync. Lines only change in between
+			 * runs, so the rest of the budget passes at once.
+			 */
+			cycles = ((int32_t)(run_end - cycles) > 0) ? run_end : cycles + 1;
+		} else {
+			block = &blocks[block_map[pc]];
+			bool translated = (block->generation == predecode_generation) &&
+				(block->start == pc);
+			if (translated && ((int32_t)(run_end - cycles) > (int32_t)block->guard)) {
+				/*
+				 * A pass only counts if its i/o reads were free of
+				 * side effects from its start.
+				 */
+				if (block->idle && idle_loops &&
+				    (!block->idle_direct || (dp == block->idle_dp)) &&
+				    idle_io_free(block)) {
+					if (block == idle_block) {
+						/*
+						 * A full pass of a polling loop changed
+						 * nothing, neither will the next ones.
+						 * Only whole passes that fit the budget
+						 * are skipped, the remainder runs as
+						 * usual.
+						 */
+						uint32_t pass = cycles - idle_start;
+						uint32_t skip = ((run_end - cycles) / pass) * pass;
+						if (skip) {
+							cycles += skip;
+							idle_cycles += skip;
+							idle_block = nullptr;
+							continue;
+						}
+					}
+					idle_block = block;
+					idle_start = cycles;
+				} else {
+					idle_block = nullptr;
+				}
+				instruction = block->instructions;
+				last_instruction = &block->instructions[block->no_of_instructions - 1];
+#ifdef MC6809_JIT
+				if (block->native) {
+					instruction += block->native(this) - 1;
+					goto block_done;
+				}
+				if (jit && (++block->heat == MC6809_JIT_HEAT)) jit_compile(block);
+#endif
+			} else {
+				idle_block = nullptr;
+				/*
+				 * A valid block that doesn't fit the rest of the
+				 * budget is kept, with its native code.
+				 */
+				if (!translated && block_head &&
+				    (++block_heat[pc] == MC6809_BLOCK_HEAT)) {
+					block_heat[pc] = 0;
+					translate_block(pc);
+				}
+				instruction = &predecode_cache[pc];
+				if (instruction->generation != predecode_generation) {
+					instruction = predecode(pc);
+				}
+				last_instruction = instruction;
+			}
+		execute:
+			pc += instruction->length;
+			cycles += instruction->cycles;
+
+			DISPATCH(instruction->index) {
+#ifdef MC6809_THREADED_DISPATCH
+			op_ill:
+#else
+			default:
+#endif
+				ill(0);
+				goto next;
+
+			/* page 1 */
+			OP(0x000, a_dir, neg)
+			OP(0x003, a_dir, com)
+			OP(0x004, a_dir, lsr)
+			OP(0x006, a_dir, ror)
+			OP(0x007, a_dir, asr)
+			OP(0x008, a_dir, asl)
+			OP(0x009, a_dir, rol)
+			OP(0x00a, a_dir, dec)
+			OP(0x00c, a_dir, inc)
+			OP(0x00d, a_dir, tst)
+			OP(0x00e, a_dir, jmp)
+			OP(0x00f, a_dir, clr)
+			OP_IH(0x010, page2)
+			OP_IH(0x011, page3)
+			OP_IH(0x012, nop)
+			OP_IH(0x013, sync)
+			OP(0x016, a_rew, lbra)
+			OP(0x017, a_rew, lbsr)
+			OP_IH(0x019, daa)
+			OP(0x01a, a_imb, orcc)
+			OP(0x01c, a_imb, andcc)
+			OP_IH(0x01d, sex)
+			OP(0x01e, a_imb, exg)
+			OP(0x01f, a_imb, tfr)
+			OP(0x020, a_reb, bra)
+			OP(0x021, a_reb, brn)
+			OP(0x022, a_reb, bhi)
+			OP(0x023, a_reb, bls)
+			OP(0x024, a_reb, bhs)
+			OP(0x025, a_reb, blo)
+			OP(0x026, a_reb, bne)
+			OP(0x027, a_reb, beq)
+			OP(0x028, a_reb, bvc)
+			OP(0x029, a_reb, bvs)
+			OP(0x02a, a_reb, bpl)
+			OP(0x02b, a_reb, bmi)
+			OP(0x02c, a_reb, bge)
+			OP(0x02d, a_reb, blt)
+			OP(0x02e, a_reb, bgt)
+			OP(0x02f, a_reb, ble)
+			OP(0x030, a_idx, leax)
+			OP(0x031, a_idx, leay)
+			OP(0x032, a_idx, leas)
+			OP(0x033, a_idx, leau)
+			OP(0x034, a_imb, pshs)
+			OP(0x035, a_imb, puls)
+			OP(0x036, a_imb, pshu)
+			OP(0x037, a_imb, pulu)
+			OP_IH(0x039, rts)
+			OP_IH(0x03a, abx)
+			OP_IH(0x03b, rti)
+			OP(0x03c, a_imb, cwai)
+			OP_IH(0x03d, mul)
+			OP_IH(0x03f, swi)
+			OP_IH(0x040, nega)
+			OP_IH(0x043, coma)
+			OP_IH(0x044, lsra)
+			OP_IH(0x046, rora)
+			OP_IH(0x047, asra)
+			OP_IH(0x048, asla)
+			OP_IH(0x049, rola)
+			OP_IH(0x04a, deca)
+			OP_IH(0x04c, inca)
+			OP_IH(0x04d, tsta)
+			OP_IH(0x04f, clra)
+			OP_IH(0x050, negb)
+			OP_IH(0x053, comb)
+			OP_IH(0x054, lsrb)
+			OP_IH(0x056, rorb)
+			OP_IH(0x057, asrb)
+			OP_IH(0x058, aslb)
+			OP_IH(0x059, rolb)
+			OP_IH(0x05a, decb)
+			OP_IH(0x05c, incb)
+			OP_IH(0x05d, tstb)
+			OP_IH(0x05f, clrb)
+			OP(0x060, a_idx, neg)
+			OP(0x063, a_idx, com)
+			OP(0x064, a_idx, lsr)
+			OP(0x066, a_idx, ror)
+			OP(0x067, a_idx, asr)
+			OP(0x068, a_idx, asl)
+			OP(0x069, a_idx, rol)
+			OP(0x06a, a_idx, dec)
+			OP(0x06c, a_idx, inc)
+			OP(0x06d, a_idx, tst)
+			OP(0x06e, a_idx, jmp)
+			OP(0x06f, a_idx, clr)
+			OP(0x070, a_ext, neg)
+			OP(0x073, a_ext, com)
+			OP(0x074, a_ext, lsr)
+			OP(0x076, a_ext, ror)
+			OP(0x077, a_ext, asr)
+			OP(0x078, a_ext, asl)
+			OP(0x079, a_ext, rol)
+			OP(0x07a, a_ext, dec)
+			OP(0x07c, a_ext, inc)
+			OP(0x07d, a_ext, tst)
+			OP(0x07e, a_ext, jmp)
+			OP(0x07f, a_ext, clr)
+			OP(0x080, a_imb, suba)
+			OP(0x081, a_imb, cmpa)
+			OP(0x082, a_imb, sbca)
+			OP(0x083, a_imw, subd)
+			OP(0x084, a_imb, anda)
+			OP(0x085, a_imb, bita)
+			OP(0x086, a_imb, lda)
+			OP(0x088, a_imb, eora)
+			OP(0x089, a_imb, adca)
+			OP(0x08a, a_imb, ora)
+			OP(0x08b, a_imb, adda)
+			OP(0x08c, a_imw, cmpx)
+			OP(0x08d, a_reb, bsr)
+			OP(0x08e, a_imw, ldx)
+			OP(0x090, a_dir, suba)
+			OP(0x091, a_dir, cmpa)
+			OP(0x092, a_dir, sbca)
+			OP(0x093, a_dir, subd)
+			OP(0x094, a_dir, anda)
+			OP(0x095, a_dir, bita)
+			OP(0x096, a_dir, lda)
+			OP(0x097, a_dir, sta)
+			OP(0x098, a_dir, eora)
+			OP(0x099, a_dir, adca)
+			OP(0x09a, a_dir, ora)
+			OP(0x09b, a_dir, adda)
+			OP(0x09c, a_dir, cmpx)
+			OP(0x09d, a_dir, jsr)
+			OP(0x09e, a_dir, ldx)
+			OP(0x09f, a_dir, stx)
+			OP(0x0a0, a_idx, suba)
+			OP(0x0a1, a_idx, cmpa)
+			OP(0x0a2, a_idx, sbca)
+			OP(0x0a3, a_idx, subd)
+			OP(0x0a4, a_idx, anda)
+			OP(0x0a5, a_idx, bita)
+			OP(0x0a6, a_idx, lda)
+			OP(0x0a7, a_idx, sta)
+			OP(0x0a8, a_idx, eora)
+			OP(0x0a9, a_idx, adca)
+			OP(0x0aa, a_idx, ora)
+			OP(0x0ab, a_idx, adda)
+			OP(0x0ac, a_idx, cmpx)
+			OP(0x0ad, a_idx, jsr)
+			OP(0x0ae, a_idx, ldx)
+			OP(0x0af, a_idx, stx)
+			OP(0x0b0, a_ext, suba)
+			OP(0x0b1, a_ext, cmpa)
+			OP(0x0b2, a_ext, sbca)
+			OP(0x0b3, a_ext, subd)
+			OP(0x0b4, a_ext, anda)
+			OP(0x0b5, a_ext, bita)
+			OP(0x0b6, a_ext, lda)
+			OP(0x0b7, a_ext, sta)
+			OP(0x0b8, a_ext, eora)
+			OP(0x0b9, a_ext, adca)
+			OP(0x0ba, a_ext, ora)
+			OP(0x0bb, a_ext, adda)
+			OP(0x0bc, a_ext, cmpx)
+			OP(0x0bd, a_ext, jsr)
+			OP(0x0be, a_ext, ldx)
+			OP(0x0bf, a_ext, stx)
+			OP(0x0c0, a_imb, subb)
+			OP(0x0c1, a_imb, cmpb)
+			OP(0x0c2, a_imb, sbcb)
+			OP(0x0c3, a_imw, addd)
+			OP(0x0c4, a_imb, andb)
+			OP(0x0c5, a_imb, bitb)
+			OP(0x0c6, a_imb, ldb)
+			OP(0x0c8, a_imb, eorb)
+			OP(0x0c9, a_imb, adcb)
+			OP(0x0ca, a_imb, orb)
+			OP(0x0cb, a_imb, addb)
+			OP(0x0cc, a_imw, ldd)
+			OP(0x0ce, a_imw, ldu)
+			OP(0x0d0, a_dir, subb)
+			OP(0x0d1, a_dir, cmpb)
+			OP(0x0d2, a_dir, sbcb)
+			OP(0x0d3, a_dir, addd)
+			OP(0x0d4, a_dir, andb)
+			OP(0x0d5, a_dir, bitb)
+			OP(0x0d6, a_dir, ldb)
+			OP(0x0d7, a_dir, stb)
+			OP(0x0d8, a_dir, eorb)
+			OP(0x0d9, a_dir, adcb)
+			OP(0x0da, a_dir, orb)
+			OP(0x0db, a_dir, addb)
+			OP(0x0dc, a_dir, ldd)
+			OP(0x0dd, a_dir, std)
+			OP(0x0de, a_dir, ldu)
+			OP(0x0df, a_dir, stu)
+			OP(0x0e0, a_idx, subb)
+			OP(0x0e1, a_idx, cmpb)
+			OP(0x0e2, a_idx, sbcb)
+			OP(0x0e3, a_idx, addd)
+			OP(0x0e4, a_idx, andb)
+			OP(0x0e5, a_idx, bitb)
+			OP(0x0e6, a_idx, ldb)
+			OP(0x0e7, a_idx, stb)
+			OP(0x0e8, a_idx, eorb)
+			OP(0x0e9, a_idx, adcb)
+			OP(0x0ea, a_idx, orb)
+			OP(0x0eb, a_idx, addb)
+			OP(0x0ec, a_idx, ldd)
+			OP(0x0ed, a_idx, std)
+			OP(0x0ee, a_idx, ldu)
+			OP(0x0ef, a_idx, stu)
+			OP(0x0f0, a_ext, subb)
+			OP(0x0f1, a_ext, cmpb)
+			OP(0x0f2, a_ext, sbcb)
+			OP(0x0f3, a_ext, addd)
+			OP(0x0f4, a_ext, andb)
+			OP(0x0f5, a_ext, bitb)
+			OP(0x0f6, a_ext, ldb)
+			OP(0x0f7, a_ext, stb)
+			OP(0x0f8, a_ext, eorb)
+			OP(0x0f9, a_ext, adcb)
+			OP(0x0fa, a_ext, orb)
+			OP(0x0fb, a_ext, addb)
+			OP(0x0fc, a_ext, ldd)
+			OP(0x0fd, a_ext, std)
+			OP(0x0fe, a_ext, ldu)
+			OP(0x0ff, a_ext, stu)
+
+			/* page 2 (prefix $10) */
+			OP(0x121, a_rew, lbrn)
+			OP(0x122, a_rew, lbhi)
+			OP(0x123, a_rew, lbls)
+			OP(0x124, a_rew, lbhs)
+			OP(0x125, a_rew, lblo)
+			OP(0x126, a_rew, lbne)
+			OP(0x127, a_rew, lbeq)
+			OP(0x128, a_rew, lbvc)
+			OP(0x129, a_rew, lbvs)
+			OP(0x12a, a_rew, lbpl)
+			OP(0x12b, a_rew, lbmi)
+			OP(0x12c, a_rew, lbge)
+			OP(0x12d, a_rew, lblt)
+			OP(0x12e, a_rew, lbgt)
+			OP(0x12f, a_rew, lble)
+			OP_IH(0x13f, swi2)
+			OP(0x183, a_imw, cmpd)
+			OP(0x18c, a_imw, cmpy)
+			OP(0x18e, a_imw, ldy)
+			OP(0x193, a_dir, cmpd)
+			OP(0x19c, a_dir, cmpy)
+			OP(0x19e, a_dir, ldy)
+			OP(0x19f, a_dir, sty)
+			OP(0x1a3, a_idx, cmpd)
+			OP(0x1ac, a_idx, cmpy)
+			OP(0x1ae, a_idx, ldy)
+			OP(0x1af, a_idx, sty)
+			OP(0x1b3, a_ext, cmpd)
+			OP(0x1bc, a_ext, cmpy)
+			OP(0x1be, a_ext, ldy)
+			OP(0x1bf, a_ext, sty)
+			OP(0x1ce, a_imw, lds)
+			OP(0x1de, a_dir, lds)
+			OP(0x1df, a_dir, sts)
+			OP(0x1ee, a_idx, lds)
+			OP(0x1ef, a_idx, sts)
+			OP(0x1fe, a_ext, lds)
+			OP(0x1ff, a_ext, sts)
+
+			/* page 3 (prefix $11) */
+			OP_IH(0x23f, swi3)
+			OP(0x283, a_imw, cmpu)
+			OP(0x28c, a_imw, cmps)
+			OP(0x293, a_dir, cmpu)
+			OP(0x29c, a_dir, cmps)
+			OP(0x2a3, a_idx, cmpu)
+			OP(0x2ac, a_idx, cmps)
+			OP(0x2b3, a_ext, cmpu)
+			OP(0x2bc, a_ext, cmps)
+			}
+		next:
+			if (instruction != last_instruction) {
+				if (block->generation == predecode_generation) {
+					instruction++;
+					goto execute;
+				}
+				// block invalidated itself, continue one by one
+			}
+#ifdef MC6809_JIT
+		block_done:
+#endif
+			block_head = ends_block[instruction->index];
+		}
+		old_nmi_line = !*attention_line || *nmi_line;
+	} while (((int32_t)(run_end - cycles) > 0) && !breakpoint_array[pc]);
+
+	return cycles - start_cycles;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::init_blocks()
+{
+	blocks = new translated_block[MC6809_BLOCK_POOL];
+	block_map = new uint16_t[65536];
+	block_heat = new uint8_t[65536];
+	block_covered = new bool[65536];
+
+	for (int i=0; i<MC6809_BLOCK_POOL; i++) {
+		blocks[i].generation = 0;
+		blocks[i].native = nullptr;
+	}
+	for (int i=0; i<65536; i++) {
+		block_map[i] = 0;
+		block_heat[i] = 0;
+		block_covered[i] = false;
+	}
+	// block 0 is never valid, it's where unmapped addresses point to
+	blocks_used = 1;
+
+	/*
+	 * Instructions that end a block: flow control, instructions that
+	 * may change the interrupt masks in cc, stack instructions and
+	 * prefixes / illegal opcodes.
+	 */
+	const execute_instruction terminators[] = {
+		&mc6809_t::bra,	&mc6809_t::brn,	&mc6809_t::bhi,	&mc6809_t::bls,
+		&mc6809_t::bhs,	&mc6809_t::blo,	&mc6809_t::bne,	&mc6809_t::beq,
+		&mc6809_t::bvc,	&mc6809_t::bvs,	&mc6809_t::bpl,	&mc6809_t::bmi,
+		&mc6809_t::bge,	&mc6809_t::blt,	&mc6809_t::bgt,	&mc6809_t::ble,
+		&mc6809_t::lbra,	&mc6809_t::lbrn,	&mc6809_t::lbhi,	&mc6809_t::lbls,
+		&mc6809_t::lbhs,	&mc6809_t::lblo,	&mc6809_t::lbne,	&mc6809_t::lbeq,
+		&mc6809_t::lbvc,	&mc6809_t::lbvs,	&mc6809_t::lbpl,	&mc6809_t::lbmi,
+		&mc6809_t::lbge,	&mc6809_t::lblt,	&mc6809_t::lbgt,	&mc6809_t::lble,
+		&mc6809_t::bsr,	&mc6809_t::lbsr,	&mc6809_t::jmp,	&mc6809_t::jsr,
+		&mc6809_t::rts,	&mc6809_t::rti,	&mc6809_t::swi,	&mc6809_t::swi2,
+		&mc6809_t::swi3,	&mc6809_t::cwai,	&mc6809_t::sync,	&mc6809_t::andcc,
+		&mc6809_t::orcc,	&mc6809_t::tfr,	&mc6809_t::exg,	&mc6809_t::pshs,
+		&mc6809_t::puls,	&mc6809_t::pshu,	&mc6809_t::pulu,	&mc6809_t::page2,
+		&mc6809_t::page3,	&mc6809_t::ill
+	};
+
+	/*
+	 * Instructions that may form an idle loop: they only read memory
+	 * and set registers and flags to the same values on every pass.
+	 * Indexed modes are left out, as they may change index registers.
+	 * Whether their reads are free of side effects depends on the
+	 * address, that's checked when translating.
+	 */
+	const execute_instruction idle_instructions[] = {
+		&mc6809_t::lda,	&mc6809_t::ldb,	&mc6809_t::ldd,	&mc6809_t::ldx,
+		&mc6809_t::ldy,	&mc6809_t::ldu,	&mc6809_t::tst,	&mc6809_t::tsta,
+		&mc6809_t::tstb,	&mc6809_t::cmpa,	&mc6809_t::cmpb,	&mc6809_t::cmpd,
+		&mc6809_t::cmpx,	&mc6809_t::cmpy,	&mc6809_t::cmpu,	&mc6809_t::cmps,
+		&mc6809_t::bita,	&mc6809_t::bitb,	&mc6809_t::anda,	&mc6809_t::andb,
+		&mc6809_t::ora,	&mc6809_t::orb,	&mc6809_t::nop
+	};
+
+	const execute_instruction branches[] = {
+		&mc6809_t::bra,	&mc6809_t::bhi,	&mc6809_t::bls,	&mc6809_t::bhs,
+		&mc6809_t::blo,	&mc6809_t::bne,	&mc6809_t::beq,	&mc6809_t::bvc,
+		&mc6809_t::bvs,	&mc6809_t::bpl,	&mc6809_t::bmi,	&mc6809_t::bge,
+		&mc6809_t::blt,	&mc6809_t::bgt,	&mc6809_t::ble,
+		&mc6809_t::lbra,	&mc6809_t::lbhi,	&mc6809_t::lbls,	&mc6809_t::lbhs,
+		&mc6809_t::lblo,	&mc6809_t::lbne,	&mc6809_t::lbeq,	&mc6809_t::lbvc,
+		&mc6809_t::lbvs,	&mc6809_t::lbpl,	&mc6809_t::lbmi,	&mc6809_t::lbge,
+		&mc6809_t::lblt,	&mc6809_t::lbgt,	&mc6809_t::lble
+	};
+
+	for (int i=0; i<768; i++) {
+		execute_instruction handler =
+			(i < 0x100) ? opcodes_page1[i & 0xff] :
+			(i < 0x200) ? opcodes_page2[i & 0xff] :
+				      opcodes_page3[i & 0xff];
+		addressing_mode mode =
+			(i < 0x100) ? addressing_modes_page1[i & 0xff] :
+			(i < 0x200) ? addressing_modes_page2[i & 0xff] :
+				      addressing_modes_page3[i & 0xff];
+		ends_block[i] = false;
+		for (unsigned int j=0; j<(sizeof(terminators)/sizeof(execute_instruction)); j++) {
+			if (handler == terminators[j]) ends_block[i] = true;
+		}
+		idle_instruction[i] = false;
+		if (mode != &mc6809_t::a_idx) {
+			for (unsigned int j=0; j<(sizeof(idle_instructions)/sizeof(execute_instruction)); j++) {
+				if (handler == idle_instructions[j]) idle_instruction[i] = true;
+			}
+		}
+		branch_instruction[i] = false;
+		for (unsigned int j=0; j<(sizeof(branches)/sizeof(execute_instruction)); j++) {
+			if (handler == branches[j]) branch_instruction[i] = true;
+		}
+	}
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::translate_block(uint16_t address)
+{
+	if (blocks_used == MC6809_BLOCK_POOL) {
+		// out of blocks, start all over again
+		for (int i=0; i<65536; i++) {
+			block_map[i] = 0;
+			block_covered[i] = false;
+		}
+		blocks_used = 1;
+	}
+
+	translated_block *block = &blocks[blocks_used];
+	predecoded_instruction *instruction;
+	uint16_t last_cycles = 0;
+	uint16_t last_address;
+	bool idle = true;
+
+	block->start = address;
+	block->guard = 0;
+	block->no_of_instructions = 0;
+	block->heat = 0;
+	block->native = nullptr;
+	block->idle_direct = false;
+	block->no_of_idle_io = 0;
+
+	do {
+		if (block->no_of_instructions && breakpoint_array[address]) break;
+
+		/*
+		 * Never read from uncacheable pages, as reads may have side
+		 * effects. This includes the indexed postbyte.
+		 */
+		if (!predecode_cacheable[address >> 8]) break;
+		instruction = &predecode_cache[address];
+		if (instruction->generation != predecode_generation) {
+			instruction = predecode(address);
+			if (instruction->generation != predecode_generation) break;
+		}
+		uint16_t operand = address + instruction->length;
+		if (!predecode_cacheable[operand >> 8]) break;
+
+		block->guard += last_cycles;
+		last_cycles = instruction->cycles + ((instruction->mode == &mc6809_t::a_idx) ? 8 : 0);
+		block->instructions[block->no_of_instructions++] = *instruction;
+		last_address = address;
+		address = operand + operand_length(operand, instruction);
+		if (!ends_block[instruction->index]) {
+			idle = idle && idle_instruction[instruction->index] &&
+				idle_read(operand, instruction, block);
+		}
+	} while (!ends_block[instruction->index] &&
+		 (block->no_of_instructions < MC6809_BLOCK_INSTRUCTIONS));
+
+	// a single instruction isn't worth a block
+	if (block->no_of_instructions < 2) return;
+
+	/*
+	 * An idle loop ends with a branch back to the start of the block
+	 */
+	instruction = &block->instructions[block->no_of_instructions - 1];
+	block->idle = false;
+	if (idle && branch_instruction[instruction->index]) {
+		uint16_t operand = last_address + instruction->length;
+		uint16_t target = (instruction->mode == &mc6809_t::a_reb) ?
+			operand + 1 + (int8_t)read_8(operand) :
+			operand + 2 + (int16_t)((read_8(operand) << 8) | read_8(operand + 1));
+		block->idle = (target == block->start);
+	}
+	block->idle_dp = dp;
+
+	block->end = address;
+	block->generation = predecode_generation;
+	block_map[block->start] = blocks_used++;
+	for (uint16_t i = block->start; i != block->end; i++) {
+		block_covered[i] = true;
+		code_map[i] = true;
+	}
+}
+
+template <class bus_t>
+bool mc6809_t<bus_t>::idle_read(uint16_t operand, predecoded_instruction *instruction, translated_block *block)
+{
+	uint16_t address;
+
+	if (instruction->mode == &mc6809_t::a_dir) {
+		address = (dp << 8) | read_8(operand);
+		block->idle_direct = true;
+	} else if (instruction->mode == &mc6809_t::a_ext) {
+		address = (read_8(operand) << 8) | read_8(operand + 1);
+	} else {
+		// immediate or inherent, no memory read
+		return true;
+	}
+
+	/*
+	 * Memory pages can be read again and again without side effects.
+	 * Bytes in i/o (uncacheable) pages are remembered, to be checked
+	 * with the embedder before skipping. Word reads cover two bytes.
+	 */
+	for (int i=0; i<2; i++) {
+		uint16_t byte_address = address + i;
+		if (!predecode_cacheable[byte_address >> 8]) {
+			if (!side_effect_free_read || (block->no_of_idle_io == MC6809_IDLE_IO))
+				return false;
+			block->idle_io[block->no_of_idle_io++] = byte_address;
+		}
+	}
+	return true;
+}
+
+template <class bus_t>
+void mc6809_t<bus_t>::invalidate_blocks(uint16_t address)
+{
+	for (int i=0; i<MC6809_BLOCK_BYTES; i++) {
+		translated_block *block = &blocks[block_map[(uint16_t)(address - i)]];
+		if ((block->start == (uint16_t)(address - i)) &&
+		    ((uint16_t)(address - block->start) < (uint16_t)(block->end - block->start))) {
+			block->generation = 0;
+		}
+	}
+}
+
+template <class bus_t>
+uint8_t mc6809_t<bus_t>::operand_length(uint16_t address, predecoded_instruction *instruction)
+{
+	if ((instruction->mode == &mc6809_t::a_imb) ||
+	    (instruction->mode == &mc6809_t::a_dir) ||
+	    (instruction->mode == &mc6809_t::a_reb)) {
+		return 1;
+	} else if ((instruction->mode == &mc6809_t::a_imw) ||
+		   (instruction->mode == &mc6809_t::a_ext) ||
+		   (instruction->mode == &mc6809_t::a_rew)) {
+		return 2;
+	} else if (instruction->mode == &mc6809_t::a_idx) {
+		uint8_t postbyte = read_8(address);
+		if (postbyte == 0b10011111) return 3;	// extended indirect
+		if (!(postbyte & 0b10000000)) return 1;	// 5 bit offset
+		switch (postbyte & 0b00001111) {
+			case 0b1000:
+			case 0b1100:
+				return 2;			// 8 bit offsets
+			case 0b1001:
+			case 0b1101:
+				return 3;			// 16 bit offsets
+			default:
+				return 1;
+		}
+	} else {
+		return 0;				// inherent, no mode
+	}
+}
+
+#undef OP_IH
+#undef OP
+#undef LABEL
+#undef DISPATCH
+#undef MC6809_THREADED_DISPATCH
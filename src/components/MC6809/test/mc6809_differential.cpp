@@ -0,0 +1,237 @@
+/*
+ * mc6809_differential.cpp  -  part of MC6809
+ *
+ * (C)2021-2022 elmerucr
+ */
+
+/*
+ * Differential test of run() (block engine, idle loops and native code)
+ * against execute(). Two cpus with their own memory run the same random
+ * program, in slices of the same budget, with the same interrupt lines
+ * and self-modifying writes in between. After every slice, consumed
+ * cycles and status must be equal, at the end all of memory. With all
+ * writes going through the bus, the clock at every write must match as
+ * well.
+ *
+ * Usage: mc6809_differential [no_of_seeds [no_of_slices]]
+ */
+
+#include "mc6809.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define SLICE	300	// cycles
+
+static uint32_t rng;
+static uint32_t rnd()
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+/*
+ * A cpu with its own ram. The write hash covers clock, address and
+ * value of each write through the bus.
+ */
+template <int n>
+class system_t {
+public:
+	static uint8_t ram[65536];
+	static mc6809 *cpu;
+	static uint32_t writes;
+
+	static uint8_t read_8(uint16_t address) { return ram[address]; }
+	static void write_8(uint16_t address, uint8_t byte)
+	{
+		ram[address] = byte;
+		writes = writes * 31 + cpu->clock_ticks() * 7 + address * 3 + byte;
+		cpu->predecode_invalidate(address);
+	}
+};
+
+template <int n> uint8_t system_t<n>::ram[65536];
+template <int n> mc6809 *system_t<n>::cpu;
+template <int n> uint32_t system_t<n>::writes;
+
+typedef system_t<0> reference;	// execute()
+typedef system_t<1> subject;	// run()
+
+enum config_t {
+	BLOCKS,		// block engine and idle loops
+	NATIVE_BUS,	// native code, reads of even pages direct, writes via bus
+	NATIVE_DIRECT	// native code, even pages read and written directly
+};
+
+static const char *config_names[] = { "blocks", "native, bus writes", "native, direct writes" };
+
+/*
+ * Random memory, with the low 16kb biased towards opcodes that form
+ * loops, or towards opcodes that are compiled inline. Some seeds add a
+ * fixed loop with an irq handler.
+ */
+static void fill_memory(uint32_t seed, uint8_t *ram)
+{
+	static const uint8_t loops[] = {
+		0x86, 0x96, 0xa6, 0xb6, 0x97, 0xa7, 0xb7, 0x26, 0x27, 0x20, 0x8b, 0x80, 0x81, 0x4a, 0x5c,
+		0x30, 0x31, 0x34, 0x35, 0x39, 0xbd, 0x10, 0x11, 0x1f, 0x1e, 0x3d, 0x19, 0x1a, 0x1c, 0xcc,
+		0xdc, 0xed, 0x8e, 0xce, 0x10, 0xc3, 0x83, 0x4d, 0x5d, 0x0d, 0x6d, 0x7d, 0x3a
+	};
+	static const uint8_t natives[] = {
+		0x86, 0x96, 0xa6, 0xb6, 0x97, 0xa7, 0xb7, 0x8b, 0x9b, 0xab, 0xbb, 0x80, 0x90, 0xa0, 0x81,
+		0x91, 0xa1, 0x84, 0x94, 0xa4, 0x8a, 0x9a, 0xaa, 0x88, 0x98, 0xa8, 0x85, 0x95, 0xa5, 0xc6,
+		0xd6, 0xe6, 0xf6, 0xd7, 0xe7, 0xf7, 0xcb, 0xdb, 0xeb, 0xc0, 0xd0, 0xe0, 0xc1, 0xe1, 0xc4,
+		0xca, 0xc8, 0xc5, 0xe5, 0xcc, 0xdc, 0xec, 0xfc, 0xdd, 0xed, 0xfd, 0x8e, 0x9e, 0xae, 0xbe,
+		0x9f, 0xaf, 0xbf, 0xce, 0xde, 0xee, 0xdf, 0xef, 0x8c, 0x9c, 0xac, 0xbc, 0xc3, 0xd3, 0xe3,
+		0x83, 0x93, 0xa3, 0x0c, 0x6c, 0x7c, 0x0a, 0x6a, 0x7a, 0x0f, 0x6f, 0x7f, 0x0d, 0x6d, 0x7d,
+		0x4c, 0x5c, 0x4a, 0x5a, 0x4f, 0x5f, 0x4d, 0x5d, 0x30, 0x31, 0x32, 0x33, 0x3a, 0x12, 0x10,
+		0x11, 0x26, 0x27, 0x20
+	};
+	static const uint8_t loop[] = {
+		0x10, 0xce, 0x80, 0x00,		// lds #$8000
+		0x1c, 0xaf,			// andcc #$af
+		0x86, 0x01,			// loop: lda #1
+		0x9b, 0x10,			// adda $10
+		0x97, 0x10,			// sta $10
+		0x8e, 0x01, 0x00,		// ldx #$100
+		0x30, 0x01,			// leax 1,x
+		0x9f, 0x12,			// stx $12
+		0xe6, 0x84,			// ldb ,x
+		0x5c,				// incb
+		0xe7, 0x88, 0x10,		// stb 16,x
+		0xa6, 0x9f, 0x00, 0x12,		// lda [$0012]
+		0x10, 0x8e, 0x20, 0x00,		// ldy #$2000
+		0x4a,				// deca
+		0x26, 0xde,			// bne loop
+		0x20, 0xdc			// bra loop
+	};
+
+	rng = seed * 2654435761u + 1;
+	for (int i=0; i<65536; i++) ram[i] = rnd();
+
+	for (int i=0; i<0x4000; i++) {
+		if (seed & 1) {
+			if (rnd() % 3) ram[i] = natives[rnd() % sizeof(natives)];
+		} else {
+			if (rnd() & 1) ram[i] = loops[rnd() % sizeof(loops)];
+		}
+	}
+	ram[0xfffe] = 0x00;
+	ram[0xffff] = 0x00;
+
+	if ((seed % 3) == 0) {
+		memcpy(&ram[0x1000], loop, sizeof(loop));
+		ram[0xfffe] = 0x10; ram[0xffff] = 0x00;	// reset
+		ram[0xfff8] = 0x30; ram[0xfff9] = 0x00;	// irq
+		ram[0xfff6] = 0x30; ram[0xfff7] = 0x00;	// firq
+		ram[0xfffc] = 0x30; ram[0xfffd] = 0x00;	// nmi
+		ram[0x3000] = 0x3b;			// rti
+	}
+}
+
+static bool test(uint32_t seed, config_t config, long no_of_slices)
+{
+	fill_memory(seed, reference::ram);
+	memcpy(subject::ram, reference::ram, 65536);
+	reference::writes = subject::writes = 0;
+
+	bool irq = true, firq = true, nmi = true;
+
+	reference::cpu = new mc6809(reference::read_8, reference::write_8);
+	subject::cpu = new mc6809(subject::read_8, subject::write_8);
+	mc6809 *cpus[2] = { reference::cpu, subject::cpu };
+	for (int i=0; i<2; i++) {
+		cpus[i]->assign_irq_line(&irq);
+		cpus[i]->assign_firq_line(&firq);
+		cpus[i]->assign_nmi_line(&nmi);
+	}
+
+	subject::cpu->set_idle_loops(true);
+	if (config != BLOCKS) {
+		subject::cpu->set_jit(true);
+		for (int i=0; i<256; i++) {
+			uint8_t *page = (i & 1) ? nullptr : &subject::ram[i << 8];
+			subject::cpu->jit_map_page(i, i ? page : nullptr,
+						   (config == NATIVE_DIRECT) ? page : nullptr);
+		}
+	}
+
+	// reset() leaves the other registers as they are
+	for (int i=0; i<2; i++) {
+		cpus[i]->reset();
+		cpus[i]->set_ac(0);
+		cpus[i]->set_br(0);
+		cpus[i]->set_xr(0);
+		cpus[i]->set_yr(0);
+		cpus[i]->set_us(0);
+		cpus[i]->set_sp(0);
+	}
+
+	char reference_status[512];
+	char subject_status[512];
+	bool passed = true;
+
+	for (long slice=0; slice<no_of_slices; slice++) {
+		uint32_t r = rnd();
+		irq = (r & 0x3f) != 0;
+		firq = (r & 0x1ff0) != 0;
+		nmi = (r & 0xffc000) != 0;
+
+		// occasionally overwrite code just ahead of pc
+		if ((r >> 24) == 0x5a) {
+			uint8_t byte = rnd();
+			reference::write_8(reference::cpu->get_pc() + (r & 7), byte);
+			subject::write_8(subject::cpu->get_pc() + (r & 7), byte);
+		}
+
+		uint32_t reference_cycles = 0;
+		do {
+			reference_cycles += reference::cpu->execute();
+		} while (!reference::cpu->breakpoint() && (reference_cycles < SLICE));
+		uint32_t subject_cycles = subject::cpu->run(SLICE);
+
+		reference::cpu->status(reference_status);
+		subject::cpu->status(subject_status);
+		if ((reference_cycles != subject_cycles) || strcmp(reference_status, subject_status)) {
+			printf("seed %u (%s): slice %li differs\n"
+			       "execute() %u cycles\n%s\n"
+			       "run()     %u cycles\n%s\n",
+			       seed, config_names[config], slice,
+			       reference_cycles, reference_status,
+			       subject_cycles, subject_status);
+			passed = false;
+			break;
+		}
+	}
+
+	if (passed && memcmp(reference::ram, subject::ram, 65536)) {
+		printf("seed %u (%s): memory differs\n", seed, config_names[config]);
+		passed = false;
+	}
+	if (passed && (config != NATIVE_DIRECT) && (reference::writes != subject::writes)) {
+		printf("seed %u (%s): clock at writes differs\n", seed, config_names[config]);
+		passed = false;
+	}
+
+	delete reference::cpu;
+	delete subject::cpu;
+	return passed;
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t no_of_seeds = (argc > 1) ? atoi(argv[1]) : 8;
+	long no_of_slices = (argc > 2) ? atol(argv[2]) : 20000;
+	int failures = 0;
+
+	for (uint32_t seed=1; seed<=no_of_seeds; seed++) {
+		for (int config=BLOCKS; config<=NATIVE_DIRECT; config++) {
+			if (!test(seed, (config_t)config, no_of_slices)) failures++;
+		}
+	}
+
+	printf("[MC6809] differential test: %u seeds, %i failures\n", no_of_seeds, failures);
+	return failures ? 1 : 0;
+}
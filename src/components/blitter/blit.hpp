@@ -21,6 +21,60 @@ enum terminal_output_type {
 	BLITTER
 };
 
+/*
+ * Decoding of blit properties, shared by blit_t and the render
+ * descriptors the blitter builds straight from display list entries.
+ *
+ * Both nibbles of a size in pixels log2 are clamped to 2 - 9.
+ */
+inline uint8_t blit_clamp_size_log2(uint8_t size)
+{
+	uint8_t width_log2 = size & 0b1111;
+	if (width_log2 < 2) {
+		width_log2 = 2;
+	} else if (width_log2 > 9) {
+		width_log2 = 9;
+	}
+	
+	uint8_t height_log2 = (size & 0b11110000) >> 4;
+	if (height_log2 < 2) {
+		height_log2 = 2;
+	} else if (height_log2 > 9) {
+		height_log2 = 9;
+	}
+	
+	return width_log2 | (height_log2 << 4);
+}
+
+/*
+ * Flags 1 with the reserved bits 2 and 3 cleared, see blit_t
+ */
+inline void blit_decode_flags_1(uint8_t flags_1, bool *hor_stretch, bool *ver_stretch,
+				bool *hor_flip, bool *ver_flip, bool *rotate)
+{
+	*hor_stretch = (flags_1 & 0b00000001) ? true : false;
+	*ver_stretch = (flags_1 & 0b00000010) ? true : false;
+	
+	switch ((flags_1 & 0b11110000) >> 4) {
+		case 0b0000:	*hor_flip = false; *ver_flip = false; *rotate = false; break;
+		case 0b0001:	*hor_flip = true ; *ver_flip = false; *rotate = false; break;
+		case 0b0010:	*hor_flip = false; *ver_flip = true ; *rotate = false; break;
+		case 0b0011:	*hor_flip = true ; *ver_flip = true ; *rotate = false; break;
+		case 0b0100:	*hor_flip = false; *ver_flip = false; *rotate = true ; break;
+		case 0b0101:	*hor_flip = true ; *ver_flip = false; *rotate = true ; break;
+		case 0b0110:	*hor_flip = false; *ver_flip = true ; *rotate = true ; break;
+		case 0b0111:	*hor_flip = true ; *ver_flip = true ; *rotate = true ; break;
+		case 0b1000:	*hor_flip = true ; *ver_flip = true ; *rotate = false; break;
+		case 0b1001:	*hor_flip = false; *ver_flip = true ; *rotate = false; break;
+		case 0b1010:	*hor_flip = true ; *ver_flip = false; *rotate = false; break;
+		case 0b1011:	*hor_flip = false; *ver_flip = false; *rotate = false; break;
+		case 0b1100:	*hor_flip = true ; *ver_flip = true ; *rotate = true ; break;
+		case 0b1101:	*hor_flip = false; *ver_flip = true ; *rotate = true ; break;
+		case 0b1110:	*hor_flip = true ; *ver_flip = false; *rotate = true ; break;
+		case 0b1111:	*hor_flip = false; *ver_flip = false; *rotate = true ; break;
+	}
+}
+
 /*
  * The next class is a surface blit. It is also used for terminal type
  * operations.
@@ -153,57 +207,13 @@ public:
 	 */
 	inline void set_size_in_pixels_log2(uint8_t size)
 	{
-		uint8_t _width_log2 = size & 0b1111;
-		if (_width_log2 < 2) {
-			_width_log2 = 2;
-		} else if (_width_log2 > 9) {
-			_width_log2 = 9;
-		}
-		
-		uint8_t _height_log2 = (size & 0b11110000) >> 4;
-		if (_height_log2 < 2) {
-			_height_log2 = 2;
-		} else if (_height_log2 > 9) {
-			_height_log2 = 9;
-		}
-		
-		if ((size & 0b1111) > 6) {
-			size = (size & 0b01110000) | 0b110;
-		}
-		if (((size & 0b1110000) >> 4) > 5) {
-			size = (size & 0b00001111) | 0b1010000;
-		}
-
-		size_in_pixels_log2 = _width_log2 | (_height_log2 << 4);
-
+		size_in_pixels_log2 = blit_clamp_size_log2(size);
 		calculate_dimensions();
 	}
 	
 	inline void set_tile_size_in_pixels_log2(uint8_t size)
 	{
-		uint8_t _width_log2 = size & 0b1111;
-		if (_width_log2 < 2) {
-			_width_log2 = 2;
-		} else if (_width_log2 > 9) {
-			_width_log2 = 9;
-		}
-		
-		uint8_t _height_log2 = (size & 0b11110000) >> 4;
-		if (_height_log2 < 2) {
-			_height_log2 = 2;
-		} else if (_height_log2 > 9) {
-			_height_log2 = 9;
-		}
-		
-		if ((size & 0b1111) > 6) {
-			size = (size & 0b01110000) | 0b110;
-		}
-		if (((size & 0b1110000) >> 4) > 5) {
-			size = (size & 0b00001111) | 0b1010000;
-		}
-
-		tile_size_in_pixels_log2 = _width_log2 | (_height_log2 << 4);
-
+		tile_size_in_pixels_log2 = blit_clamp_size_log2(size);
 		calculate_dimensions();
 	}
 
@@ -253,37 +263,7 @@ public:
 	inline void process_flags_1()
 	{
 		flags_1 &= 0b11110011;
-		
-		if (flags_1 & 0b00000001) {
-			hor_stretch = true;
-		} else {
-			hor_stretch = false;
-		}
-		
-		if (flags_1 & 0b00000010) {
-			ver_stretch = true;
-		} else {
-			ver_stretch = false;
-		}
-		
-		switch ((flags_1 & 0b11110000) >> 4) {
-			case 0b0000:	hor_flip = false; ver_flip = false; rotate = false; break;
-			case 0b0001:	hor_flip = true ; ver_flip = false; rotate = false; break;
-			case 0b0010:	hor_flip = false; ver_flip = true ; rotate = false; break;
-			case 0b0011:	hor_flip = true ; ver_flip = true ; rotate = false; break;
-			case 0b0100:	hor_flip = false; ver_flip = false; rotate = true ; break;
-			case 0b0101:	hor_flip = true ; ver_flip = false; rotate = true ; break;
-			case 0b0110:	hor_flip = false; ver_flip = true ; rotate = true ; break;
-			case 0b0111:	hor_flip = true ; ver_flip = true ; rotate = true ; break;
-			case 0b1000:	hor_flip = true ; ver_flip = true ; rotate = false; break;
-			case 0b1001:	hor_flip = false; ver_flip = true ; rotate = false; break;
-			case 0b1010:	hor_flip = true ; ver_flip = false; rotate = false; break;
-			case 0b1011:	hor_flip = false; ver_flip = false; rotate = false; break;
-			case 0b1100:	hor_flip = true ; ver_flip = true ; rotate = true ; break;
-			case 0b1101:	hor_flip = false; ver_flip = true ; rotate = true ; break;
-			case 0b1110:	hor_flip = true ; ver_flip = false; rotate = true ; break;
-			case 0b1111:	hor_flip = false; ver_flip = false; rotate = true ; break;
-		}
+		blit_decode_flags_1(flags_1, &hor_stretch, &ver_stretch, &hor_flip, &ver_flip, &rotate);
 	}
 
 	inline uint8_t get_size_in_pixels_log2()
@@ -300,6 +280,12 @@ public:
 	uint16_t rows;
 	uint16_t tiles;
 
+	/*
+	 * Tile ram of a blit is a ring, origin is the tile shown at the
+	 * top left. Terminal scrolling moves it by one row of tiles.
+	 */
+	uint16_t origin;
+
 	uint16_t cursor_position;
 	uint8_t  cursor_interval;
 	uint8_t  cursor_countdown;
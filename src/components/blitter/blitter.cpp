@@ -8,24 +8,42 @@
 #include "blitter.hpp"
 #include "rom.hpp"
 #include "common.hpp"
+#include "blend.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 
-E64::blitter_ic::blitter_ic()
+/*
+ * Flags selecting a blit kernel
+ */
+#define BLIT_KERNEL_BACKGROUND		0b00000001
+#define BLIT_KERNEL_MULTICOLOR		0b00000010
+#define BLIT_KERNEL_COLOR_PER_TILE	0b00000100
+#define BLIT_KERNEL_CBM_FONT		0b00001000
+#define BLIT_KERNEL_HOR_STRETCH		0b00010000
+#define BLIT_KERNEL_VER_STRETCH		0b00100000
+
+E64::blitter_ic::blitter_ic(bool fill_pattern)
 {
 	fb = new uint16_t[TOTAL_PIXELS];
-
-	general_ram =               new uint8_t [GENERAL_RAM_ELEMENTS];			//   2mb
-	tile_ram  =                 new uint8_t [TILE_RAM_ELEMENTS];			//   2mb
-	tile_foreground_color_ram = new uint16_t[TILE_FOREGROUND_COLOR_RAM_ELEMENTS];	//   2mb
-	tile_background_color_ram = new uint16_t[TILE_BACKGROUND_COLOR_RAM_ELEMENTS];	//   2mb
-	pixel_ram =                 new uint16_t[PIXEL_RAM_ELEMENTS];			//   8mb +
-											// ============
-											//  16mb total
+	fb_draw = fb;
 
 	/*
-	 * Fill blit memory alternating 64 bytes 0x00 and 64 bytes 0xff
+	 * calloc'ed memory is only really allocated when touched, so
+	 * without the pattern only the memory in use will be.
 	 */
-	for (int i=0; i < (0x100 * 0x10000); i++) {
-		video_memory_write_8(i, i & 0b1000000 ? 0xff : 0x00);
+	video_memory = (uint8_t *)calloc(VIDEO_MEMORY_SIZE, 1);
+
+	if (fill_pattern) {
+		/*
+		 * Fill blit memory alternating 64 bytes 0x00 and 64 bytes
+		 * 0xff. Do the first 128 bytes, then keep doubling.
+		 */
+		memset(&video_memory[0x40], 0xff, 0x40);
+		for (uint32_t size = 0x80; size < VIDEO_MEMORY_SIZE; size <<= 1) {
+			memcpy(&video_memory[size], video_memory, size);
+		}
 	}
 
 	/*
@@ -57,6 +75,7 @@ E64::blitter_ic::blitter_ic()
 		blit[i].background_color = 0;
 		blit[i].x_pos = 0;
 		blit[i].y_pos = 0;
+		blit[i].origin = 0;
 	}
 
 	/*
@@ -79,17 +98,45 @@ E64::blitter_ic::blitter_ic()
 	}
 	
 	exceptions_connected = false;
+	mmu = nullptr;
+
+	no_of_bands = 1;
+	workers_generation = 0;
+	workers_busy = 0;
+	workers_quit = false;
+
+	pipelined = false;
+	pipeline_busy = false;
+	pipeline_quit = false;
+	pipeline_pending = false;
+	pipeline_copy_front = false;
+	pipeline_first_operation = 0;
+
+	fsm_blitter_state = FSM_IDLE;
+	operations.resize(OPERATIONS_MIN);
+	operations_mask = OPERATIONS_MIN - 1;
+	operations_dropped = 0;
+	head = 0;
+	tail = 0;
+
+	for (int i = 0; i < 256; i++) {
+		blit_version[i] = 0;
+		blit_cache[i].state = BLIT_CACHE_EMPTY;
+		blit_cache[i].batch = 0;
+	}
+	blit_cache_batch = 0;
+	blit_cache_bytes = 0;
+	fsm_blit_cached = false;
+	memset(pipeline_blocks, 0, sizeof(pipeline_blocks));
 }
 
 E64::blitter_ic::~blitter_ic()
 {
+	pipeline_stop();
+	stop_workers();
 	delete [] cbm_font;
 	delete [] blit;
-	delete [] pixel_ram;
-	delete [] tile_background_color_ram;
-	delete [] tile_foreground_color_ram;
-	delete [] tile_ram;
-	delete [] general_ram;
+	free(video_memory);
 	delete [] fb;
 }
 
@@ -100,19 +147,40 @@ void E64::blitter_ic::connect_exceptions_ic(exceptions_ic *exceptions_unit)
 	exceptions_connected = true;
 }
 
+void E64::blitter_ic::connect_mmu_ic(mmu_ic *mmu_unit)
+{
+	mmu = mmu_unit;
+}
+
+void E64::blitter_ic::invalidate_code(uint32_t address)
+{
+	mmu->invalidate_physical(address & VIDEO_MEMORY_MASK);
+}
+
 void E64::blitter_ic::reset()
 {
+	sync();
+	pipeline_pending = false;
+	pipeline_copy_front = false;
+
 	fsm_blitter_state = FSM_IDLE;
 
 	head = 0;
 	tail = 0;
+	pipeline_first_operation = 0;
 
 	for (int i=0; i<TOTAL_PIXELS; i++) {
 		fb[i] = 0xf222;
 	}
+	if (fb_draw != fb) memcpy(fb_draw, fb, TOTAL_PIXELS * sizeof(uint16_t));
+	fb_transparent = false;
+	fb_front_transparent = false;
 
 	pending_screenrefresh_irq = false;
 	generate_screenrefresh_irq = false;
+
+	display_list = 0;
+	display_list_on_refresh = false;
 	
 	if (exceptions_connected) exceptions->release(irq_number);
 }
@@ -120,23 +188,41 @@ void E64::blitter_ic::reset()
 inline void E64::blitter_ic::check_new_operation()
 {
 	if (head != tail) {
-		switch (operations[tail].type) {
+		struct operation *op = &operations[tail & operations_mask];
+
+		switch (op->type) {
 			case CLEAR:
 				fsm_blitter_state = FSM_CLEARING;
 				fsm_total_no_of_pix = PIXELS_PER_SCANLINE * SCANLINES;
+				fsm_clear_transparent = true;
 				break;
 			case HOR_BORDER:
 				fsm_blitter_state = FSM_DRAW_HOR_BORDER;
 				fsm_total_no_of_pix = PIXELS_PER_SCANLINE * hor_border_size;
+				if (fsm_total_no_of_pix && (hor_border_color & 0xf000)) fb_transparent = false;
 				break;
 			case VER_BORDER:
 				fsm_blitter_state = FSM_DRAW_VER_BORDER;
 				fsm_total_no_of_pix = SCANLINES * ver_border_size;
+				if (fsm_total_no_of_pix && (ver_border_color & 0xf000)) fb_transparent = false;
 				break;
 			case BLIT:
-				fsm_blitter_state = FSM_BLITTING;
-				fsm_current_blit = &operations[tail].blit;
-				fsm_total_no_of_pix = fsm_current_blit->width_on_screen * fsm_current_blit->height_on_screen;
+				{
+					fsm_blitter_state = FSM_BLITTING;
+					fsm_current_blit = &op->blit;
+					fsm_total_no_of_pix = fsm_current_blit->width_on_screen * fsm_current_blit->height_on_screen;
+
+					struct blit_clip_t clip;
+					calculate_blit_clipping(fsm_current_blit, 0, SCANLINES, &clip);
+					if ((clip.column_start < clip.column_end) && (clip.row_start < clip.row_end)) {
+						fb_transparent = false;
+					}
+
+					fsm_blit_cached = blit_cache_lookup(fsm_current_blit);
+					fsm_blit_kernel = fsm_blit_cached ?
+						blit_cached_kernels[(fsm_current_blit->kernel_flags >> 4) & 0b11] :
+						blit_kernels[fsm_current_blit->kernel_flags];
+				}
 				break;
 		}
 		pixel = 0;
@@ -146,146 +232,848 @@ inline void E64::blitter_ic::check_new_operation()
 
 void E64::blitter_ic::run(int no_of_cycles)
 {
+	if (pipelined) {
+		/*
+		 * Finish and show the jobs of the previous run
+		 */
+		sync();
+		if (pipeline_pending) {
+			std::swap(fb, fb_draw);
+			fb_front_transparent = pipeline_transparent;
+			pipeline_pending = false;
+			pipeline_copy_front = true;
+		}
+		memset(pipeline_blocks, 0, sizeof(pipeline_blocks));
+	}
+
+	blit_cache_batch++;
+
 	while (no_of_cycles > 0) {
 		no_of_cycles--;
 
-		switch (fsm_blitter_state) {
-		case FSM_IDLE:
+		if (fsm_blitter_state == FSM_IDLE) {
 			check_new_operation();
-			break;
-		case FSM_CLEARING:
-			if (pixel != fsm_total_no_of_pix) {
-				fb[pixel] = clear_color;
-				pixel++;
+		} else if (pixel != fsm_total_no_of_pix) {
+			/*
+			 * Every pixel (clipped or not) still takes one
+			 * cycle, but all pixels the budget allows for
+			 * are processed in one go.
+			 */
+			uint32_t count = fsm_total_no_of_pix - pixel;
+			if (count > (uint32_t)no_of_cycles + 1) {
+				count = no_of_cycles + 1;
+			}
+			no_of_cycles -= count - 1;
+
+			switch (fsm_blitter_state) {
+			case FSM_CLEARING:
+				add_job(CLEAR, count);
+				if (clear_color & 0xf000) {
+					fsm_clear_transparent = false;
+					fb_transparent = false;
+				}
+				break;
+			case FSM_DRAW_HOR_BORDER:
+				add_job(HOR_BORDER, count);
+				break;
+			case FSM_DRAW_VER_BORDER:
+				add_job(VER_BORDER, count);
+				break;
+			case FSM_BLITTING:
+				add_job(BLIT, count);
+				break;
+			default:
+				break;
+			}
+		} else {
+			if ((fsm_blitter_state == FSM_CLEARING) && fsm_clear_transparent) {
+				fb_transparent = true;
+			}
+			fsm_blitter_state = FSM_IDLE;
+		}
+	}
+
+	if (pipelined) {
+		if (!jobs.empty()) {
+			pipeline_launch();
+		} else {
+			fb_front_transparent = fb_transparent;
+		}
+	} else if (!jobs.empty()) {
+		execute_jobs();
+	}
+}
+
+void E64::blitter_ic::add_job(enum operation_type type, uint32_t count)
+{
+	struct job_t job;
+
+	if ((type == BLIT) && fsm_blit_cached) {
+		/*
+		 * Contents may have changed since the previous run, if
+		 * so continue without cache.
+		 */
+		struct blit_cache_t *c = &blit_cache[fsm_current_blit->number];
+		if (c->version != blit_version[fsm_current_blit->number]) {
+			fsm_blit_cached = false;
+			fsm_blit_kernel = blit_kernels[fsm_current_blit->kernel_flags];
+		} else {
+			c->batch = blit_cache_batch;
+		}
+	}
+
+	job.type = type;
+	job.blit = fsm_current_blit;
+	job.kernel = fsm_blit_kernel;
+	job.first_pixel = pixel;
+	job.no_of_pixels = count;
+
+	switch (type) {
+	case CLEAR:
+		job.color = clear_color;
+		job.border_size = 0;
+		break;
+	case HOR_BORDER:
+		job.color = hor_border_color;
+		job.border_size = hor_border_size;
+		break;
+	case VER_BORDER:
+		job.color = ver_border_color;
+		job.border_size = ver_border_size;
+		break;
+	case BLIT:
+		job.color = 0;
+		job.border_size = 0;
+		break;
+	}
+
+	pixel += count;
+
+	if (pipelined) {
+		if (jobs.empty()) pipeline_first_operation = tail - 1;
+		if (type == BLIT) pipeline_mark_blit(job.blit);
+		jobs.push_back(job);
+	} else if (no_of_bands > 1) {
+		jobs.push_back(job);
+	} else {
+		execute_job(&job, 0, SCANLINES);
+	}
+}
+
+/*
+ * Executes a job, but only for the framebuffer scanlines in
+ * [first_scanline, last_scanline).
+ */
+void E64::blitter_ic::execute_job(const struct job_t *job, uint32_t first_scanline, uint32_t last_scanline)
+{
+	uint32_t band_start = first_scanline * PIXELS_PER_SCANLINE;
+	uint32_t band_end = last_scanline * PIXELS_PER_SCANLINE;
+	uint32_t end = job->first_pixel + job->no_of_pixels;
+	uint16_t color = job->color;
+
+	switch (job->type) {
+	case CLEAR:
+		{
+			uint32_t start = std::max(job->first_pixel, band_start);
+			uint32_t stop = std::min(end, band_end);
+			if (start < stop) std::fill_n(&fb_draw[start], stop - start, color);
+		}
+		break;
+	case HOR_BORDER:
+		for (uint32_t p = job->first_pixel; p < end; p++) {
+			uint32_t top = p;
+			uint32_t bottom = (TOTAL_PIXELS-1) - p;
+			if ((top >= band_start) && (top < band_end)) host.video->alpha_blend(&fb_draw[top], &color);
+			if ((bottom >= band_start) && (bottom < band_end)) host.video->alpha_blend(&fb_draw[bottom], &color);
+		}
+		break;
+	case VER_BORDER:
+		if (job->border_size == 0) break;
+		for (uint32_t p = job->first_pixel; p < end; p++) {
+			uint32_t left = (p % job->border_size) + ((p / job->border_size) * PIXELS_PER_SCANLINE);
+			uint32_t right = (TOTAL_PIXELS-1) - left;
+			if ((left >= band_start) && (left < band_end)) host.video->alpha_blend(&fb_draw[left], &color);
+			if ((right >= band_start) && (right < band_end)) host.video->alpha_blend(&fb_draw[right], &color);
+		}
+		break;
+	case BLIT:
+		{
+			/*
+			 * Split the pixels into runs per row and skip
+			 * everything outside the clipping area.
+			 */
+			const struct blit_descriptor_t *b = job->blit;
+			struct blit_clip_t clip;
+			calculate_blit_clipping(b, first_scanline, last_scanline, &clip);
+
+			uint32_t p = job->first_pixel;
+
+			while (p < end) {
+				uint32_t row = p >> b->width_on_screen_log2;
+				uint32_t row_pixel = row << b->width_on_screen_log2;
+				uint32_t column = p - row_pixel;
+				uint32_t column_end = end - row_pixel;
+				if (column_end > b->width_on_screen) {
+					column_end = b->width_on_screen;
+				}
+
+				p = row_pixel + column_end;
+
+				if ((row < clip.row_start) || (row >= clip.row_end)) continue;
+				if (column < clip.column_start) column = clip.column_start;
+				if (column_end > clip.column_end) column_end = clip.column_end;
+				if (column < column_end) (this->*job->kernel)(b, &clip, row, column, column_end);
+			}
+		}
+		break;
+	}
+}
+
+void E64::blitter_ic::set_threads(int no_of_threads)
+{
+	sync();
+	stop_workers();
+
+	if (no_of_threads < 1) no_of_threads = 1;
+	if (no_of_threads > 16) no_of_threads = 16;
+	no_of_bands = no_of_threads;
+
+	workers_quit = false;
+	for (int i = 1; i < no_of_bands; i++) {
+		workers.emplace_back(&blitter_ic::worker, this, i, workers_generation);
+	}
+}
+
+void E64::blitter_ic::stop_workers()
+{
+	{
+		std::lock_guard<std::mutex> lock(workers_mutex);
+		workers_quit = true;
+	}
+	workers_start.notify_all();
+
+	for (std::thread &w : workers) w.join();
+	workers.clear();
+	no_of_bands = 1;
+}
+
+void E64::blitter_ic::worker(int band, uint32_t generation)
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(workers_mutex);
+			workers_start.wait(lock, [&] { return workers_quit || (workers_generation != generation); });
+			if (workers_quit) return;
+			generation = workers_generation;
+		}
+
+		execute_band(band);
+
+		{
+			std::lock_guard<std::mutex> lock(workers_mutex);
+			if (--workers_busy == 0) workers_done.notify_one();
+		}
+	}
+}
+
+void E64::blitter_ic::execute_band(int band)
+{
+	uint32_t first_scanline = (band * SCANLINES) / no_of_bands;
+	uint32_t last_scanline = ((band + 1) * SCANLINES) / no_of_bands;
+
+	for (const struct job_t &job : jobs) execute_job(&job, first_scanline, last_scanline);
+}
+
+void E64::blitter_ic::execute_jobs()
+{
+	{
+		std::lock_guard<std::mutex> lock(workers_mutex);
+		workers_busy = no_of_bands - 1;
+		workers_generation++;
+	}
+	workers_start.notify_all();
+
+	execute_band(0);
+
+	{
+		std::unique_lock<std::mutex> lock(workers_mutex);
+		workers_done.wait(lock, [this] { return workers_busy == 0; });
+	}
+
+	jobs.clear();
+}
+
+void E64::blitter_ic::set_pipelined(bool value)
+{
+	if (value == pipelined) return;
+
+	if (value) {
+		fb_draw = new uint16_t[TOTAL_PIXELS];
+		memcpy(fb_draw, fb, TOTAL_PIXELS * sizeof(uint16_t));
+		fb_front_transparent = fb_transparent;
+		pipeline_pending = false;
+		pipeline_copy_front = false;
+		pipeline_quit = false;
+		pipeline_thread = std::thread(&blitter_ic::pipeline_worker, this);
+		pipelined = true;
+	} else {
+		pipeline_stop();
+	}
+}
+
+void E64::blitter_ic::pipeline_stop()
+{
+	if (!pipelined) return;
+
+	sync();
+	if (pipeline_pending) {
+		std::swap(fb, fb_draw);
+		pipeline_pending = false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(pipeline_mutex);
+		pipeline_quit = true;
+	}
+	pipeline_start.notify_one();
+	pipeline_thread.join();
+
+	delete [] fb_draw;
+	fb_draw = fb;
+	pipelined = false;
+}
+
+void E64::blitter_ic::pipeline_worker()
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(pipeline_mutex);
+			pipeline_start.wait(lock, [this] { return pipeline_quit || pipeline_busy.load(); });
+			if (pipeline_quit) return;
+		}
+
+		if (pipeline_copy_front) {
+			memcpy(fb_draw, fb, TOTAL_PIXELS * sizeof(uint16_t));
+			pipeline_copy_front = false;
+		}
+
+		execute_jobs();
+
+		{
+			std::lock_guard<std::mutex> lock(pipeline_mutex);
+			pipeline_busy.store(false, std::memory_order_release);
+		}
+		pipeline_done.notify_all();
+	}
+}
+
+void E64::blitter_ic::pipeline_launch()
+{
+	pipeline_transparent = fb_transparent;
+	pipeline_pending = true;
+
+	{
+		std::lock_guard<std::mutex> lock(pipeline_mutex);
+		pipeline_busy.store(true, std::memory_order_release);
+	}
+	pipeline_start.notify_one();
+}
+
+void E64::blitter_ic::pipeline_wait()
+{
+	std::unique_lock<std::mutex> lock(pipeline_mutex);
+	pipeline_done.wait(lock, [this] { return !pipeline_busy.load(); });
+}
+
+/*
+ * Marks the 8kb blocks of [offset, offset + size) in a region of
+ * video memory, wrapping around within the region.
+ */
+void E64::blitter_ic::pipeline_mark(uint32_t region_start, uint32_t region_size,
+				    uint32_t offset, uint32_t size)
+{
+	if (size >= region_size) {
+		offset = 0;
+		size = region_size;
+	}
+	offset &= region_size - 1;
+
+	const uint32_t block_size = 1 << PIPELINE_BLOCK_LOG2;
+
+	for (uint32_t a = offset & ~(block_size - 1); a < offset + size; a += block_size) {
+		pipeline_blocks[(region_start + (a & (region_size - 1))) >> PIPELINE_BLOCK_LOG2] = 1;
+	}
+}
+
+/*
+ * Marks all video memory a blit reads from, see blit_run()
+ */
+void E64::blitter_ic::pipeline_mark_blit(const struct blit_descriptor_t *b)
+{
+	uint32_t tiles = 1 << (b->width_in_tiles_log2 + b->height_in_tiles_log2);
+
+	pipeline_mark(TILE_RAM_START, TILE_RAM_ELEMENTS, b->number << 13, tiles);
+
+	if (b->color_per_tile) {
+		pipeline_mark(TILE_FOREGROUND_COLOR_RAM_START, TILE_FOREGROUND_COLOR_RAM_ELEMENTS << 1,
+			      b->number << 13, tiles << 1);
+		pipeline_mark(TILE_BACKGROUND_COLOR_RAM_START, TILE_BACKGROUND_COLOR_RAM_ELEMENTS << 1,
+			      b->number << 13, tiles << 1);
+	}
+
+	if (!b->use_cbm_font) {
+		pipeline_mark(PIXEL_RAM_START, PIXEL_RAM_ELEMENTS << 1, b->number << 15,
+			      (256 << (b->tile_width_log2 + b->tile_height_log2)) << 1);
+	}
+}
+
+/*
+ * Calculates the range [start, end) of n positions p for which
+ * origin + (step * p) lies within [0, limit). Step is 1 or -1.
+ */
+static inline void clip_range(int32_t origin, int32_t step, int32_t n,
+			      int32_t limit, uint32_t *start, uint32_t *end)
+{
+	int32_t s, e;
+
+	if (step > 0) {
+		s = -origin;
+		e = limit - origin;
+	} else {
+		s = origin - limit + 1;
+		e = origin + 1;
+	}
+	if (s < 0) s = 0;
+	if (e > n) e = n;
+	if (e < s) e = s;
+
+	*start = s;
+	*end = e;
+}
+
+/*
+ * Clipping of blit b to the scanlines [first_scanline, last_scanline)
+ * of the framebuffer.
+ */
+void E64::blitter_ic::calculate_blit_clipping(const struct blit_descriptor_t *b, int32_t first_scanline,
+					      int32_t last_scanline, struct blit_clip_t *clip)
+{
+	/*
+	 * Screen coordinate of column 0 and row 0 and their direction.
+	 * Rotation moves columns onto the vertical axis and rows onto
+	 * the horizontal one. Note that a rotated blit is shifted one
+	 * pixel to the right (height_on_screen - y, without - 1).
+	 */
+	int32_t column_origin, column_step, row_origin, row_step;
+
+	if (b->rotate) {
+		column_origin = b->y_pos + (b->hor_flip ? b->width_on_screen - 1 : 0);
+		column_step = b->hor_flip ? -1 : 1;
+		row_origin = b->x_pos + (b->ver_flip ? 1 : b->height_on_screen);
+		row_step = b->ver_flip ? 1 : -1;
+
+		clip_range(column_origin - first_scanline, column_step, b->width_on_screen,
+			   last_scanline - first_scanline, &clip->column_start, &clip->column_end);
+		clip_range(row_origin, row_step, b->height_on_screen, PIXELS_PER_SCANLINE,
+			   &clip->row_start, &clip->row_end);
+
+		clip->fb_origin = row_origin + (column_origin * PIXELS_PER_SCANLINE);
+		clip->fb_column_step = column_step * PIXELS_PER_SCANLINE;
+		clip->fb_row_step = row_step;
+	} else {
+		column_origin = b->x_pos + (b->hor_flip ? b->width_on_screen - 1 : 0);
+		column_step = b->hor_flip ? -1 : 1;
+		row_origin = b->y_pos + (b->ver_flip ? b->height_on_screen - 1 : 0);
+		row_step = b->ver_flip ? -1 : 1;
+
+		clip_range(column_origin, column_step, b->width_on_screen, PIXELS_PER_SCANLINE,
+			   &clip->column_start, &clip->column_end);
+		clip_range(row_origin - first_scanline, row_step, b->height_on_screen,
+			   last_scanline - first_scanline, &clip->row_start, &clip->row_end);
+
+		clip->fb_origin = column_origin + (row_origin * PIXELS_PER_SCANLINE);
+		clip->fb_column_step = column_step;
+		clip->fb_row_step = row_step * PIXELS_PER_SCANLINE;
+	}
+}
+
+/*
+ * Collects the source colors of columns [column, column_end) of one
+ * row of a blit into run. Tile index and colors are looked up once
+ * per tile. All flags that matter per pixel are template parameters,
+ * so the inner loop has no branches on them.
+ */
+template <uint8_t kernel_flags>
+inline void E64::blitter_ic::blit_fetch(const struct blit_descriptor_t *b, uint32_t row,
+					uint32_t column, uint32_t column_end, uint16_t *run)
+{
+	const bool background     = kernel_flags & BLIT_KERNEL_BACKGROUND;
+	const bool multicolor     = kernel_flags & BLIT_KERNEL_MULTICOLOR;
+	const bool color_per_tile = kernel_flags & BLIT_KERNEL_COLOR_PER_TILE;
+	const bool cbm            = kernel_flags & BLIT_KERNEL_CBM_FONT;
+	const int  hor_shift      = (kernel_flags & BLIT_KERNEL_HOR_STRETCH) ? 1 : 0;
+	const int  ver_shift      = (kernel_flags & BLIT_KERNEL_VER_STRETCH) ? 1 : 0;
+
+	uint16_t y_in_blit = row >> ver_shift;
+	uint16_t tile_row = ((y_in_blit >> b->tile_height_log2) << b->width_in_tiles_log2) + b->origin;
+	uint32_t row_in_tile = (y_in_blit & b->tile_height_mask) << b->tile_width_log2;
+	uint16_t tile_width_mask = b->tile_width_mask;
+
+	/*
+	 * Glyph cache covers cbm font tiles up to 64 pixels
+	 */
+	const bool glyphs = cbm && ((b->tile_width_log2 + b->tile_height_log2) <= 6);
+
+	uint16_t *run_color = run;
+
+	uint16_t foreground_color = b->foreground_color;
+	uint16_t background_color = b->background_color;
+	uint32_t blit_base = b->number << 14;
+
+	while (column < column_end) {
+		uint16_t x_in_blit = column >> hor_shift;
+		uint16_t tile_number = ((x_in_blit >> b->tile_width_log2) + tile_row) & b->tiles_mask;
+
+		/*
+		 * First column of the next tile, or end of run
+		 */
+		uint32_t tile_end = ((x_in_blit | tile_width_mask) + 1) << hor_shift;
+		if (tile_end > column_end) tile_end = column_end;
+
+		uint8_t tile_index = video_memory[tile_address((b->number << 13) + tile_number)];
+
+		/*
+		 * Replace foreground and background colors
+		 * if color per tile.
+		 */
+		if (color_per_tile) {
+			foreground_color = video_memory_read_16(tile_fg_color_address((b->number << 12) + tile_number));
+			background_color = video_memory_read_16(tile_bg_color_address((b->number << 12) + tile_number));
+		}
+
+		if (glyphs) {
+			/*
+			 * Copy the row of the glyph, with colors
+			 * already resolved.
+			 */
+			const uint16_t *glyph_row = cbm_glyph(tile_index, foreground_color, background_color, b,
+							      kernel_flags & (BLIT_KERNEL_BACKGROUND | BLIT_KERNEL_MULTICOLOR)) + row_in_tile;
+			if (hor_shift) {
+				for (; column < tile_end; column++) *run_color++ = glyph_row[(column >> 1) & tile_width_mask];
 			} else {
-				fsm_blitter_state = FSM_IDLE;
+				uint32_t n = tile_end - column;
+				memcpy(run_color, &glyph_row[column & tile_width_mask], n * sizeof(uint16_t));
+				run_color += n;
+				column = tile_end;
 			}
-			break;
-		case FSM_DRAW_HOR_BORDER:
-			if (pixel != fsm_total_no_of_pix) {
-				host.video->alpha_blend(&fb[pixel], &hor_border_color);
-				host.video->alpha_blend(&fb[(TOTAL_PIXELS-1) - pixel], &hor_border_color);
-				pixel++;
+			continue;
+		}
+
+		const uint16_t *font = &cbm_font[0];
+		uint32_t font_tile = tile_index << 6;
+		uint32_t tile_pixels = tile_index << (b->tile_width_log2 + b->tile_height_log2);
+
+		for (; column < tile_end; column++) {
+			uint32_t pixel_in_tile = ((column >> hor_shift) & tile_width_mask) | row_in_tile;
+			uint16_t source_color;
+
+			/*
+			 * Pick the right pixel from blit depending on bitmap mode or tile mode,
+			 * and based on cbm_font or not
+			 */
+			if (cbm) {
+				source_color = font[(font_tile | pixel_in_tile) & 0x3fff];
 			} else {
-				fsm_blitter_state = FSM_IDLE;
+				source_color = video_memory_read_16(pixel_address(blit_base + (tile_pixels | pixel_in_tile)));
 			}
-			break;
-		case FSM_DRAW_VER_BORDER:
-			if (pixel != fsm_total_no_of_pix) {
-				uint32_t norm_pixel = (pixel % ver_border_size) + ((pixel / ver_border_size) * PIXELS_PER_SCANLINE);
-				host.video->alpha_blend(&fb[norm_pixel], &ver_border_color);
-				host.video->alpha_blend(&fb[(TOTAL_PIXELS-1) - norm_pixel], &ver_border_color);
-				pixel++;
+
+			/*
+			 * Check for multicolor or simple color
+			 *
+			 * If the source color has an alpha value of higher than 0x0 (pixel present),
+			 * and not in multicolor mode, replace with foreground color.
+			 *
+			 * If there's no alpha value (no pixel), and we have background 'on',
+			 * replace the color with background color.
+			 */
+			if (source_color & 0xf000) {
+				if (!multicolor) source_color = foreground_color;
 			} else {
-				fsm_blitter_state = FSM_IDLE;
+				if (background) source_color = background_color;
 			}
-			break;
-		case FSM_BLITTING:
-			if (pixel != fsm_total_no_of_pix) {
-				if (fsm_current_blit->hor_flip) {
-					fsm_temp_x = fsm_current_blit->width_on_screen - (pixel & fsm_current_blit->width_on_screen_mask) - 1;
-				} else {
-					fsm_temp_x = pixel & fsm_current_blit->width_on_screen_mask;
-				}
-				
-				if (fsm_current_blit->ver_flip) {
-					fsm_temp_y = fsm_current_blit->height_on_screen - (pixel >> fsm_current_blit->width_on_screen_log2) - 1;
-				} else {
-					fsm_temp_y = pixel >> fsm_current_blit->width_on_screen_log2;
-				}
-				
-				/*
-				 * Rotate transformation. Max rotation is 90 degrees
-				 * to the right, all others are combinations of this
-				 * rotation and flips.
-				 */
-				if (fsm_current_blit->rotate) {
-					fsm_temp_holder = fsm_temp_y;
-					fsm_temp_y = fsm_temp_x;
-					fsm_temp_x = fsm_current_blit->height_on_screen - fsm_temp_holder;
-				}
-				
-				fsm_scrn_x = fsm_current_blit->x_pos + fsm_temp_x;
-
-				if (fsm_scrn_x < PIXELS_PER_SCANLINE) {     // clipping check horizontally
-					fsm_scrn_y = fsm_current_blit->y_pos + fsm_temp_y;
-
-					if (fsm_scrn_y < SCANLINES) {       // clipping check vertically
-						/*
-						 * Transformation of pixel_no to take into account double width and/or height. After
-						 * this <complex> transformation, the normalized_pixel_no points to a position in the
-						 * source material.
-						 * NEEDS WORK: document this transformation properly
-						 */
-						fsm_normalized_pixel_no = (((pixel >> (fsm_current_blit->ver_stretch ? 1 : 0)) & ~fsm_current_blit->width_on_screen_mask) | (pixel & fsm_current_blit->width_on_screen_mask)) >> (fsm_current_blit->hor_stretch ? 1 : 0);
-
-						/*
-						 * Calculate the current x and y positions within
-						 * the current blit source pixeldata.
-						 */
-						x_in_blit = fsm_normalized_pixel_no & fsm_current_blit->width_mask;
-						y_in_blit = fsm_normalized_pixel_no >> (fsm_current_blit->width_log2);
-
-						tile_x = x_in_blit >> (fsm_current_blit->tile_width_log2);
-						tile_y = y_in_blit >> (fsm_current_blit->tile_height_log2);
-
-						tile_number = tile_x + (tile_y << (fsm_current_blit->width_in_tiles_log2));
-
-						tile_index = tile_ram[((fsm_current_blit->number << 13) + tile_number) & TILE_RAM_ELEMENTS_MASK];
-
-						/*
-						 * Replace foreground and background colors
-						 * if color per tile.
-						 */
-						if (fsm_current_blit->color_per_tile) {
-							fsm_current_blit->foreground_color = tile_foreground_color_ram[((fsm_current_blit->number << 12) + tile_number) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK];
-							fsm_current_blit->background_color = tile_background_color_ram[((fsm_current_blit->number << 12) + tile_number) & TILE_BACKGROUND_COLOR_RAM_ELEMENTS_MASK];
-						}
 
-						pixel_in_tile = (x_in_blit & (fsm_current_blit->tile_width_mask)) | ((y_in_blit & (fsm_current_blit->tile_height_mask)) << (fsm_current_blit->tile_width_log2));
+			*run_color++ = source_color;
+		}
+	}
+}
 
-						/*
-						 * Pick the right pixel from blit depending on bitmap mode or tile mode,
-						 * and based on cbm_font or not
-						 */
-						if (fsm_current_blit->use_cbm_font) {
-							source_color = cbm_font[((tile_index << 6) | pixel_in_tile) & 0x3fff];
-						} else {
-							source_color = pixel_ram[((fsm_current_blit->number << 14) + ((tile_index << (fsm_current_blit->tile_width_log2 + fsm_current_blit->tile_height_log2)) | pixel_in_tile)) & PIXEL_RAM_ELEMENTS_MASK];
-						}
+/*
+ * Glyph cache, direct mapped. Every thread that draws has its own, so
+ * band workers and the pipeline thread don't need locking. All
+ * blitters unpack the same font, so they can share it.
+ */
+struct glyph_t {
+	uint64_t key;		// 0 if unused
+	uint16_t pixels[64];
+};
 
-						/*
-						 * Check for multicolor or simple color
-						 *
-						 * If the source color has an alpha value of higher than 0x0 (pixel present),
-						 * and not in multicolor mode, replace with foreground color.
-						 *
-						 * If there's no alpha value (no pixel), and we have background 'on',
-						 * replace the color with background color.
-						 *
-						 * At this stage, we have already checked for color per
-						 * tile, and if so, the value of foreground and respectively
-						 * background color have been replaced accordingly.
-						 */
-						if (source_color & 0xf000) {
-							if (!fsm_current_blit->multicolor_mode) source_color = fsm_current_blit->foreground_color;
-						} else {
-							if (fsm_current_blit->background) source_color = fsm_current_blit->background_color;
-						}
+static thread_local std::vector<struct glyph_t> glyph_cache;
 
-						/*
-						 * Finally, call the alpha blend function
-						 */
-						host.video->alpha_blend(&fb[fsm_scrn_x + (fsm_scrn_y * PIXELS_PER_SCANLINE)], &source_color);
-					}
-				}
-				pixel++;
+const uint16_t *E64::blitter_ic::cbm_glyph(uint8_t tile_index, uint16_t foreground_color,
+					   uint16_t background_color, const struct blit_descriptor_t *b,
+					   uint8_t kernel_flags)
+{
+	uint64_t key =
+		(1ULL << 63) |
+		((uint64_t)kernel_flags << 48) |
+		((uint64_t)b->tile_height_log2 << 44) |
+		((uint64_t)b->tile_width_log2 << 40) |
+		((uint64_t)background_color << 24) |
+		((uint64_t)foreground_color << 8) |
+		tile_index;
+
+	if (glyph_cache.empty()) glyph_cache.resize(GLYPH_CACHE_ENTRIES);
+
+	struct glyph_t *g = &glyph_cache[(key * 0x9e3779b97f4a7c15ULL) >> (64 - GLYPH_CACHE_ENTRIES_LOG2)];
+
+	if (g->key != key) {
+		uint32_t font_tile = tile_index << 6;
+		uint32_t pixels = 1 << (b->tile_width_log2 + b->tile_height_log2);
+
+		for (uint32_t i = 0; i < pixels; i++) {
+			uint16_t color = cbm_font[font_tile | i];
+
+			if (color & 0xf000) {
+				if (!(kernel_flags & BLIT_KERNEL_MULTICOLOR)) color = foreground_color;
 			} else {
-				fsm_blitter_state = FSM_IDLE;
+				if (kernel_flags & BLIT_KERNEL_BACKGROUND) color = background_color;
+			}
+			g->pixels[i] = color;
+		}
+		g->key = key;
+	}
+
+	return g->pixels;
+}
+
+/*
+ * Blends the source colors of columns [column, column + run_length) of
+ * one row of a blit into the framebuffer.
+ */
+void E64::blitter_ic::draw_run(const struct blit_clip_t *clip, uint32_t row, uint32_t column,
+			       const uint16_t *run, uint32_t run_length)
+{
+	int32_t fb_step = clip->fb_column_step;
+	int32_t fb_index = clip->fb_origin + (column * fb_step) + (row * clip->fb_row_step);
+
+	if (fb_step == 1) {
+		alpha_blend_row(&fb_draw[fb_index], run, run_length);
+	} else if (fb_step == -1) {
+		uint16_t reversed[1024];
+		std::reverse_copy(run, run + run_length, reversed);
+		alpha_blend_row(&fb_draw[fb_index - (run_length - 1)], reversed, run_length);
+	} else {
+		/*
+		 * Rotated, run goes down a column of the framebuffer.
+		 * Opaque pixels are stored, transparent ones skipped.
+		 */
+		video_t *video = host.video;
+
+		for (uint32_t i = 0; i < run_length; i++) {
+			switch (run[i] & 0xf000) {
+			case 0xf000:
+				fb_draw[fb_index] = run[i];
+				break;
+			case 0x0000:
+				break;
+			default:
+				{
+					uint16_t color = run[i];
+					video->alpha_blend(&fb_draw[fb_index], &color);
+				}
+				break;
+			}
+			fb_index += fb_step;
+		}
+	}
+}
+
+/*
+ * Draws columns [column, column_end) of one row of the current blit.
+ */
+template <uint8_t kernel_flags>
+void E64::blitter_ic::blit_run(const struct blit_descriptor_t *b, const struct blit_clip_t *clip,
+			       uint32_t row, uint32_t column, uint32_t column_end)
+{
+	uint16_t run[1024];
+
+	blit_fetch<kernel_flags>(b, row, column, column_end, run);
+	draw_run(clip, row, column, run, column_end - column);
+}
+
+/*
+ * Same, but the source colors come from the blit cache. Only the
+ * stretch flags are used.
+ */
+template <uint8_t kernel_flags>
+void E64::blitter_ic::blit_run_cached(const struct blit_descriptor_t *b, const struct blit_clip_t *clip,
+				      uint32_t row, uint32_t column, uint32_t column_end)
+{
+	const int hor_shift = (kernel_flags & BLIT_KERNEL_HOR_STRETCH) ? 1 : 0;
+	const int ver_shift = (kernel_flags & BLIT_KERNEL_VER_STRETCH) ? 1 : 0;
+
+	const uint16_t *source = &blit_cache[b->number].pixels[(row >> ver_shift) << (b->width_on_screen_log2 - hor_shift)];
+
+	if (hor_shift) {
+		uint16_t run[1024];
+		for (uint32_t i = column; i < column_end; i++) run[i - column] = source[i >> 1];
+		draw_run(clip, row, column, run, column_end - column);
+	} else {
+		draw_run(clip, row, column, &source[column], column_end - column);
+	}
+}
+
+#define BLIT_KERNEL(n)		&E64::blitter_ic::blit_run<(n)>
+#define BLIT_KERNELS_4(n)	BLIT_KERNEL(n), BLIT_KERNEL((n)+1), BLIT_KERNEL((n)+2), BLIT_KERNEL((n)+3)
+#define BLIT_KERNELS_16(n)	BLIT_KERNELS_4(n), BLIT_KERNELS_4((n)+4), BLIT_KERNELS_4((n)+8), BLIT_KERNELS_4((n)+12)
+
+const E64::blitter_ic::blit_kernel_t E64::blitter_ic::blit_kernels[64] = {
+	BLIT_KERNELS_16(0), BLIT_KERNELS_16(16), BLIT_KERNELS_16(32), BLIT_KERNELS_16(48)
+};
+
+#undef BLIT_KERNELS_16
+#undef BLIT_KERNELS_4
+#undef BLIT_KERNEL
+
+const E64::blitter_ic::blit_kernel_t E64::blitter_ic::blit_cached_kernels[4] = {
+	&E64::blitter_ic::blit_run_cached<0>,
+	&E64::blitter_ic::blit_run_cached<BLIT_KERNEL_HOR_STRETCH>,
+	&E64::blitter_ic::blit_run_cached<BLIT_KERNEL_VER_STRETCH>,
+	&E64::blitter_ic::blit_run_cached<BLIT_KERNEL_HOR_STRETCH | BLIT_KERNEL_VER_STRETCH>
+};
+
+#define BLIT_FETCHER(n)		&E64::blitter_ic::blit_fetch<(n)>
+
+const E64::blitter_ic::blit_fetcher_t E64::blitter_ic::blit_fetchers[16] = {
+	BLIT_FETCHER(0),  BLIT_FETCHER(1),  BLIT_FETCHER(2),  BLIT_FETCHER(3),
+	BLIT_FETCHER(4),  BLIT_FETCHER(5),  BLIT_FETCHER(6),  BLIT_FETCHER(7),
+	BLIT_FETCHER(8),  BLIT_FETCHER(9),  BLIT_FETCHER(10), BLIT_FETCHER(11),
+	BLIT_FETCHER(12), BLIT_FETCHER(13), BLIT_FETCHER(14), BLIT_FETCHER(15)
+};
+
+#undef BLIT_FETCHER
+
+/*
+ * A blit can be cached if everything it reads lies within its own
+ * windows of tile, tile color and pixel ram, so blit_version tells
+ * whether it changed.
+ */
+bool E64::blitter_ic::blit_cacheable(const struct blit_descriptor_t *b)
+{
+	int tiles_log2 = b->width_in_tiles_log2 + b->height_in_tiles_log2;
+
+	if (tiles_log2 > 13) return false;
+	if (b->color_per_tile && (tiles_log2 > 12)) return false;
+	if (!b->use_cbm_font && ((b->tile_width_log2 + b->tile_height_log2) > 6)) return false;
+
+	return true;
+}
+
+void E64::blitter_ic::blit_cache_key(const struct blit_descriptor_t *b, struct blit_cache_key_t *key)
+{
+	int hor_shift = (b->kernel_flags & BLIT_KERNEL_HOR_STRETCH) ? 1 : 0;
+	int ver_shift = (b->kernel_flags & BLIT_KERNEL_VER_STRETCH) ? 1 : 0;
+
+	key->kernel_flags = b->kernel_flags & ~(BLIT_KERNEL_HOR_STRETCH | BLIT_KERNEL_VER_STRETCH);
+	key->width_log2 = b->width_on_screen_log2 - hor_shift;
+	key->height = b->height_on_screen >> ver_shift;
+	key->tile_width_log2 = b->tile_width_log2;
+	key->tile_height_log2 = b->tile_height_log2;
+	key->foreground_color = b->foreground_color;
+	key->background_color = b->background_color;
+	key->origin = b->origin;
+}
+
+void E64::blitter_ic::blit_cache_release(struct blit_cache_t *c)
+{
+	blit_cache_bytes -= c->pixels.size() * sizeof(uint16_t);
+	std::vector<uint16_t>().swap(c->pixels);
+	c->state = BLIT_CACHE_EMPTY;
+}
+
+/*
+ * Rasterizes the (unstretched) blit into its cache entry. Least
+ * recently used entries are released to stay below
+ * BLIT_CACHE_MAX_BYTES, except for the ones jobs of this run use.
+ */
+bool E64::blitter_ic::blit_cache_fill(const struct blit_descriptor_t *b, struct blit_cache_t *c)
+{
+	uint32_t width_log2 = c->key.width_log2;
+	uint32_t height = c->key.height;
+	size_t bytes = (height << width_log2) * sizeof(uint16_t);
+
+	while (blit_cache_bytes + bytes > BLIT_CACHE_MAX_BYTES) {
+		struct blit_cache_t *oldest = nullptr;
+		for (int i = 0; i < 256; i++) {
+			struct blit_cache_t *e = &blit_cache[i];
+			if ((e->state == BLIT_CACHE_FILLED) && (e->batch != blit_cache_batch) &&
+			    (!oldest || (e->batch < oldest->batch))) {
+				oldest = e;
 			}
-			break;
 		}
+		if (!oldest) return false;
+		blit_cache_release(oldest);
+	}
+
+	c->pixels.resize(height << width_log2);
+	blit_cache_bytes += bytes;
+
+	blit_fetcher_t fetch = blit_fetchers[b->kernel_flags & 0x0f];
+	for (uint32_t y = 0; y < height; y++) {
+		(this->*fetch)(b, y, 0, 1 << width_log2, &c->pixels[y << width_log2]);
 	}
+
+	c->state = BLIT_CACHE_FILLED;
+	return true;
+}
+
+/*
+ * Returns true if blit b can be drawn from its cache entry. A blit is
+ * cached the second time it is seen unchanged. Entries that jobs of
+ * this run refer to are not touched.
+ */
+bool E64::blitter_ic::blit_cache_lookup(const struct blit_descriptor_t *b)
+{
+	if (!blit_cacheable(b)) return false;
+
+	struct blit_cache_t *c = &blit_cache[b->number];
+	struct blit_cache_key_t key;
+	blit_cache_key(b, &key);
+	uint32_t version = blit_version[b->number];
+
+	bool unchanged = (c->state != BLIT_CACHE_EMPTY) && (c->key == key) && (c->version == version);
+
+	if (c->state == BLIT_CACHE_FILLED) {
+		if (unchanged) {
+			c->batch = blit_cache_batch;
+			return true;
+		}
+		if (c->batch == blit_cache_batch) return false;
+		blit_cache_release(c);
+	}
+
+	if (unchanged) {
+		if (blit_cache_fill(b, c)) {
+			c->batch = blit_cache_batch;
+			return true;
+		}
+		return false;
+	}
+
+	c->state = BLIT_CACHE_SEEN;
+	c->key = key;
+	c->version = version;
+	return false;
 }
 
 void E64::blitter_ic::set_clear_color(uint16_t color)
@@ -293,32 +1081,163 @@ void E64::blitter_ic::set_clear_color(uint16_t color)
 	clear_color = color;
 }
 
+/*
+ * Returns true if there's room for one more operation. Entries from
+ * the oldest operation that is still drawn up to head are in use.
+ */
+bool E64::blitter_ic::make_room_for_operation()
+{
+	uint32_t oldest = (fsm_blitter_state == FSM_IDLE) ? tail : tail - 1;
+
+	if (pipelined && ((head - pipeline_first_operation) > operations_mask)) {
+		// entries are released once the pipeline is done
+		sync();
+	}
+
+	if ((head - oldest) <= operations_mask) return true;
+
+	if (operations.size() < OPERATIONS_MAX) {
+		sync();
+
+		std::vector<struct operation> grown(operations.size() << 1);
+		uint32_t grown_mask = (uint32_t)grown.size() - 1;
+
+		for (uint32_t i = oldest; i != head; i++) {
+			grown[i & grown_mask] = operations[i & operations_mask];
+		}
+		operations.swap(grown);
+		operations_mask = grown_mask;
+
+		if (fsm_blitter_state == FSM_BLITTING) {
+			fsm_current_blit = &operations[(tail - 1) & operations_mask].blit;
+		}
+		return true;
+	}
+
+	if (operations_dropped++ == 0) {
+		printf("[Blitter] Operation ring full (%u entries), dropping operations\n", OPERATIONS_MAX);
+	}
+	return false;
+}
+
 void E64::blitter_ic::add_operation_clear_framebuffer()
 {
-	operations[head].type = CLEAR;
-	// leaves blit structure for what it is
-	head++;
+	struct operation *op = new_operation();
+	if (op) op->type = CLEAR;
 }
 
 void E64::blitter_ic::add_operation_draw_hor_border()
 {
-	operations[head].type = HOR_BORDER;
-	// leaves blit structure for what it is
-	head++;
+	struct operation *op = new_operation();
+	if (op) op->type = HOR_BORDER;
 }
 
 void E64::blitter_ic::add_operation_draw_ver_border()
 {
-	operations[head].type = VER_BORDER;
-	// leaves blit structure for what it is
-	head++;
+	struct operation *op = new_operation();
+	if (op) op->type = VER_BORDER;
+}
+
+static inline uint8_t blit_kernel_flags(bool background, bool multicolor_mode, bool color_per_tile,
+					bool use_cbm_font, bool hor_stretch, bool ver_stretch)
+{
+	return
+		(background      ? BLIT_KERNEL_BACKGROUND     : 0) |
+		(multicolor_mode ? BLIT_KERNEL_MULTICOLOR     : 0) |
+		(color_per_tile  ? BLIT_KERNEL_COLOR_PER_TILE : 0) |
+		(use_cbm_font    ? BLIT_KERNEL_CBM_FONT       : 0) |
+		(hor_stretch     ? BLIT_KERNEL_HOR_STRETCH    : 0) |
+		(ver_stretch     ? BLIT_KERNEL_VER_STRETCH    : 0);
+}
+
+void E64::blitter_ic::describe_blit(const blit_t *blit, struct blit_descriptor_t *d)
+{
+	d->number = blit->number;
+	d->kernel_flags = blit_kernel_flags(blit->background, blit->multicolor_mode,
+					    blit->color_per_tile, blit->use_cbm_font,
+					    blit->hor_stretch, blit->ver_stretch);
+
+	d->color_per_tile = blit->color_per_tile;
+	d->use_cbm_font = blit->use_cbm_font;
+	d->hor_flip = blit->hor_flip;
+	d->ver_flip = blit->ver_flip;
+	d->rotate = blit->rotate;
+
+	d->width_in_tiles_log2 = blit->width_in_tiles_log2;
+	d->height_in_tiles_log2 = blit->height_in_tiles_log2;
+	d->tile_width_log2 = blit->tile_width_log2;
+	d->tile_height_log2 = blit->tile_height_log2;
+	d->width_on_screen_log2 = blit->width_on_screen_log2;
+
+	d->tile_width_mask = blit->tile_width_mask;
+	d->tile_height_mask = blit->tile_height_mask;
+	d->width_on_screen = blit->width_on_screen;
+	d->height_on_screen = blit->height_on_screen;
+
+	d->foreground_color = blit->foreground_color;
+	d->background_color = blit->background_color;
+
+	d->x_pos = blit->x_pos;
+	d->y_pos = blit->y_pos;
+
+	d->tiles_mask = (1 << (blit->width_in_tiles_log2 + blit->height_in_tiles_log2)) - 1;
+	d->origin = blit->origin & d->tiles_mask;
+}
+
+void E64::blitter_ic::describe_display_list_blit(uint32_t entry, struct blit_descriptor_t *d)
+{
+	const uint8_t *e = &video_memory[entry];
+
+	/*
+	 * Only the number comes from the blit context, everything else
+	 * is decoded from the entry the same way blit_t does.
+	 */
+	d->number = blit[e[DISPLAY_LIST_NUMBER]].number;
+
+	const uint8_t flags_0 = e[DISPLAY_LIST_FLAGS_0];
+	bool hor_stretch, ver_stretch;
+	blit_decode_flags_1(e[DISPLAY_LIST_FLAGS_1] & 0b11110011, &hor_stretch, &ver_stretch,
+			    &d->hor_flip, &d->ver_flip, &d->rotate);
+
+	d->color_per_tile = flags_0 & 0x08 ? true : false;
+	d->use_cbm_font   = flags_0 & 0x80 ? true : false;
+	d->kernel_flags = blit_kernel_flags(flags_0 & 0x02, flags_0 & 0x04,
+					    d->color_per_tile, d->use_cbm_font,
+					    hor_stretch, ver_stretch);
+
+	const uint8_t size = blit_clamp_size_log2(e[DISPLAY_LIST_SIZE_PIXELS_LOG2]);
+	const uint8_t tile_size = blit_clamp_size_log2(e[DISPLAY_LIST_TILE_SIZE_LOG2]);
+	const uint8_t width_log2 = size & 0b1111;
+	const uint8_t height_log2 = (size & 0b11110000) >> 4;
+
+	d->tile_width_log2 = tile_size & 0b1111;
+	d->tile_height_log2 = (tile_size & 0b11110000) >> 4;
+	d->width_in_tiles_log2 = (width_log2 < d->tile_width_log2) ? 0 : width_log2 - d->tile_width_log2;
+	d->height_in_tiles_log2 = (height_log2 < d->tile_height_log2) ? 0 : height_log2 - d->tile_height_log2;
+	d->width_on_screen_log2 = width_log2 + hor_stretch;
+
+	d->tile_width_mask = (1 << d->tile_width_log2) - 1;
+	d->tile_height_mask = (1 << d->tile_height_log2) - 1;
+	d->width_on_screen = 1 << d->width_on_screen_log2;
+	d->height_on_screen = 1 << (height_log2 + ver_stretch);
+
+	d->foreground_color = video_memory_read_16(entry + DISPLAY_LIST_FG_COLOR);
+	d->background_color = video_memory_read_16(entry + DISPLAY_LIST_BG_COLOR);
+
+	d->x_pos = video_memory_read_16(entry + DISPLAY_LIST_XPOS);
+	d->y_pos = video_memory_read_16(entry + DISPLAY_LIST_YPOS);
+
+	d->tiles_mask = (1 << (d->width_in_tiles_log2 + d->height_in_tiles_log2)) - 1;
+	d->origin = video_memory_read_16(entry + DISPLAY_LIST_ORIGIN) & d->tiles_mask;
 }
 
 void E64::blitter_ic::add_operation_draw_blit(blit_t *blit)
 {
-	operations[head].type = BLIT;
-	operations[head].blit = *blit;
-	head++;
+	struct operation *op = new_operation();
+	if (!op) return;
+
+	op->type = BLIT;
+	describe_blit(blit, &op->blit);
 }
 
 uint8_t E64::blitter_ic::io_read_8(uint16_t address)
@@ -338,6 +1257,14 @@ uint8_t E64::blitter_ic::io_read_8(uint16_t address)
 					} else {
 						return 0b00000000;
 					}
+				case BLITTER_DISPLAY_LIST_CR:
+					return display_list_on_refresh ? 0b00000010 : 0b00000000;
+				case BLITTER_DISPLAY_LIST:
+					return (display_list & 0xff0000) >> 16;
+				case BLITTER_DISPLAY_LIST+1:
+					return (display_list & 0x00ff00) >> 8;
+				case BLITTER_DISPLAY_LIST+2:
+					return display_list & 0xff;
 				case BLITTER_HOR_BORDER_SIZE:
 					return hor_border_size;
 				case BLITTER_VER_BORDER_SIZE:
@@ -415,6 +1342,19 @@ void E64::blitter_ic::io_write_8(uint16_t address, uint8_t byte)
 					if (byte & 0b00000010) add_operation_draw_hor_border();
 					if (byte & 0b00000100) add_operation_draw_ver_border();
 					break;
+				case BLITTER_DISPLAY_LIST_CR:
+					display_list_on_refresh = (byte & 0b00000010) ? true : false;
+					if (byte & 0b00000001) run_display_list();
+					break;
+				case BLITTER_DISPLAY_LIST:
+					display_list = (display_list & 0x00ffff) | (byte << 16);
+					break;
+				case BLITTER_DISPLAY_LIST+1:
+					display_list = (display_list & 0xff00ff) | (byte << 8);
+					break;
+				case BLITTER_DISPLAY_LIST+2:
+					display_list = (display_list & 0xffff00) | byte;
+					break;
 				case BLITTER_HOR_BORDER_SIZE:
 					hor_border_size = byte;
 					break;
@@ -553,19 +1493,23 @@ uint8_t E64::blitter_ic::io_blit_context_read_8(uint8_t blit_no, uint8_t address
 			return blit[blit_no].columns;
 		case BLIT_CURSOR_CHAR:
 			// character at cursor pos
-			return tile_ram[((blit_no << 13) + blit[blit_no].cursor_position) & TILE_RAM_ELEMENTS_MASK];
+			return video_memory[tile_address((blit_no << 13) + terminal_tile(blit_no, blit[blit_no].cursor_position))];
 		case BLIT_CURSOR_FG_COLOR_MSB:
 			// foreground color at cursor msb
-			return (tile_foreground_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] & 0xff00) >> 8;
+			return video_memory[tile_fg_color_address(((blit_no << 12) + terminal_tile(blit_no, blit[blit_no].cursor_position)))];
 		case BLIT_CURSOR_FG_COLOR_LSB:
 			// foreground color at cursor lsb
-			return tile_foreground_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] & 0x00ff;
+			return video_memory[tile_fg_color_address(((blit_no << 12) + terminal_tile(blit_no, blit[blit_no].cursor_position))) + 1];
 		case BLIT_CURSOR_BG_COLOR_MSB:
 			// background color at cursor msb
-			return (tile_background_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] & 0xff00) >> 8;
+			return video_memory[tile_bg_color_address(((blit_no << 12) + terminal_tile(blit_no, blit[blit_no].cursor_position)))];
 		case BLIT_CURSOR_BG_COLOR_LSB:
 			// background color at cursor lsb
-			return tile_background_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] & 0x00ff;
+			return video_memory[tile_bg_color_address(((blit_no << 12) + terminal_tile(blit_no, blit[blit_no].cursor_position))) + 1];
+		case BLIT_ORIGIN_MSB:
+			return (blit[blit_no].origin & 0xff00) >> 8;
+		case BLIT_ORIGIN_LSB:
+			return blit[blit_no].origin & 0xff;
 		default:
 			return 0;
 	}
@@ -682,27 +1626,29 @@ void E64::blitter_ic::io_blit_context_write_8(uint8_t blit_no, uint8_t address,
 			break;
 		case BLIT_CURSOR_CHAR:
 			// character at cursor pos
-			tile_ram[((blit_no << 13) + blit[blit_no].cursor_position) & TILE_RAM_ELEMENTS_MASK] = byte;
+			video_memory_write_8(tile_address((blit_no << 13) + terminal_tile(blit_no, blit[blit_no].cursor_position)), byte);
 			break;
 		case BLIT_CURSOR_FG_COLOR_MSB:
 			// foreground color at cursor msb
-			tile_foreground_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] =
-			(tile_foreground_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] & 0x00ff) | (byte << 8);
+			video_memory_write_8(tile_fg_color_address(((blit_no << 12) + terminal_tile(blit_no, blit[blit_no].cursor_position))), byte);
 			break;
 		case BLIT_CURSOR_FG_COLOR_LSB:
 			// foreground color at cursor lsb
-			tile_foreground_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] =
-			(tile_foreground_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] & 0xff00) | byte;
+			video_memory_write_8(tile_fg_color_address(((blit_no << 12) + terminal_tile(blit_no, blit[blit_no].cursor_position))) + 1, byte);
 			break;
 		case BLIT_CURSOR_BG_COLOR_MSB:
 			// background color at cursor msb
-			tile_background_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] =
-			(tile_background_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] & 0x00ff) | (byte << 8);
+			video_memory_write_8(tile_bg_color_address(((blit_no << 12) + terminal_tile(blit_no, blit[blit_no].cursor_position))), byte);
 			break;
 		case BLIT_CURSOR_BG_COLOR_LSB:
 			// background color at cursor lsb
-			tile_background_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] =
-			(tile_background_color_ram[((blit_no << 12) + blit[blit_no].cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] & 0xff00) | byte;
+			video_memory_write_8(tile_bg_color_address(((blit_no << 12) + terminal_tile(blit_no, blit[blit_no].cursor_position))) + 1, byte);
+			break;
+		case BLIT_ORIGIN_MSB:
+			blit[blit_no].origin = (blit[blit_no].origin & 0x00ff) | (byte << 8);
+			break;
+		case BLIT_ORIGIN_LSB:
+			blit[blit_no].origin = (blit[blit_no].origin & 0xff00) | byte;
 			break;
 		default:
 			// do nothing
@@ -710,8 +1656,51 @@ void E64::blitter_ic::io_blit_context_write_8(uint8_t blit_no, uint8_t address,
 	}
 }
 
+void E64::blitter_ic::run_display_list()
+{
+	uint32_t entry = display_list & VIDEO_MEMORY_MASK & ~(DISPLAY_LIST_ENTRY_SIZE - 1);
+
+	for (int i = 0; i < DISPLAY_LIST_MAX_ENTRIES; i++) {
+		uint8_t *e = &video_memory[entry];
+
+		switch (e[DISPLAY_LIST_COMMAND]) {
+			case DISPLAY_LIST_END:
+				return;
+			case DISPLAY_LIST_BLIT:
+				{
+					/*
+					 * Fill the descriptor in the ring straight
+					 * from the entry, no copy of the blit context.
+					 */
+					struct operation *op = new_operation();
+					if (op) {
+						op->type = BLIT;
+						describe_display_list_blit(entry, &op->blit);
+					}
+				}
+				break;
+			case DISPLAY_LIST_CLEAR:
+				add_operation_clear_framebuffer();
+				break;
+			case DISPLAY_LIST_HOR_BORDER:
+				add_operation_draw_hor_border();
+				break;
+			case DISPLAY_LIST_VER_BORDER:
+				add_operation_draw_ver_border();
+				break;
+			default:
+				// DISPLAY_LIST_SKIP and unknown commands
+				break;
+		}
+
+		entry = (entry + DISPLAY_LIST_ENTRY_SIZE) & VIDEO_MEMORY_MASK;
+	}
+}
+
 void E64::blitter_ic::notify_screen_refreshed()
 {
+	if (display_list_on_refresh) run_display_list();
+
 	// do something with interrupt line (if enabled)
 	if (generate_screenrefresh_irq && exceptions_connected) {
 		pending_screenrefresh_irq = true;
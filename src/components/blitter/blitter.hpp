@@ -20,6 +20,7 @@
    #define BLITTER_SR			0x00	// blitter status register (pending irq's)
    #define BLITTER_CR			0x01	// blitter control register (irq activation)
    #define BLITTER_TASK			0x02	// initiate clear buffer or border draws
+   #define BLITTER_DISPLAY_LIST_CR	0x03	// bit 0: run display list now, bit 1: run on each screen refresh
    #define BLITTER_HOR_BORDER_SIZE	0x08	// horizontal border size
    #define BLITTER_VER_BORDER_SIZE	0x09	// vertical border size
    #define BLITTER_HOR_BORDER_COLOR	0x0a	// horizontal border color
@@ -32,6 +33,7 @@
    #define BLITTER_CONTEXT_4		0x14	// seen from 0xa0-0xbf
    #define BLITTER_CONTEXT_5		0x15	// seen from 0xc0-0xdf
    #define BLITTER_CONTEXT_6		0x16	// seen from 0xe0-0xff
+   #define BLITTER_DISPLAY_LIST		0x18	// 24 bit address of display list in video memory (0x18-0x1a)
 
 /* =========================================================================================
  * Individual blit context registers (based on context registers), relative to start context
@@ -61,11 +63,40 @@
    #define BLIT_CURSOR_FG_COLOR_LSB	0x19
    #define BLIT_CURSOR_BG_COLOR_MSB	0x1a
    #define BLIT_CURSOR_BG_COLOR_LSB	0x1b
+   #define BLIT_ORIGIN_MSB		0x1c	// tile shown at top left, tile ram is a ring
+   #define BLIT_ORIGIN_LSB		0x1d
 
 /*
  * 0x20, 0x40, 0x60, 0x80, 0xa0, 0xc0, 0xe0: start of blit contexts
  */
 
+/* =========================================================================================
+ * Display list, entries of 16 bytes in video memory (16 bit values big endian). The list
+ * ends with an END entry, or after DISPLAY_LIST_MAX_ENTRIES. A BLIT entry draws blit
+ * 'number' with the properties of the entry, the blit context itself is not changed.
+ * ========================================================================================= */
+   #define DISPLAY_LIST_COMMAND		0x00	// see below
+   #define DISPLAY_LIST_NUMBER		0x01	// blit number (tile, color and pixel ram used)
+   #define DISPLAY_LIST_FLAGS_0		0x02	// as BLIT_FLAGS_0
+   #define DISPLAY_LIST_FLAGS_1		0x03	// as BLIT_FLAGS_1
+   #define DISPLAY_LIST_SIZE_PIXELS_LOG2	0x04	// as BLIT_SIZE_PIXELS_LOG2
+   #define DISPLAY_LIST_TILE_SIZE_LOG2	0x05	// as BLIT_TILE_SIZE_LOG2
+   #define DISPLAY_LIST_FG_COLOR		0x06
+   #define DISPLAY_LIST_BG_COLOR		0x08
+   #define DISPLAY_LIST_XPOS		0x0a
+   #define DISPLAY_LIST_YPOS		0x0c
+   #define DISPLAY_LIST_ORIGIN		0x0e	// as BLIT_ORIGIN
+   #define DISPLAY_LIST_ENTRY_SIZE	0x10
+
+   #define DISPLAY_LIST_END		0x00	// commands
+   #define DISPLAY_LIST_BLIT		0x01
+   #define DISPLAY_LIST_SKIP		0x02	// entry switched off, continue with next
+   #define DISPLAY_LIST_CLEAR		0x03
+   #define DISPLAY_LIST_HOR_BORDER	0x04
+   #define DISPLAY_LIST_VER_BORDER	0x05
+
+   #define DISPLAY_LIST_MAX_ENTRIES	4096
+
 #ifndef BLITTER_HPP
 #define BLITTER_HPP
 
@@ -75,18 +106,44 @@
 #define TILE_BACKGROUND_COLOR_RAM_ELEMENTS	0x100000	// each 2 bytes, 2mb, starts @ $600000 to $7fffff, steps of $2000
 #define PIXEL_RAM_ELEMENTS			0x400000	// each 2 bytes, 8mb, starts @ $800000 to $ffffff, steps of $8000
 
+#define VIDEO_MEMORY_SIZE			0x1000000	// 16mb, 16 bit elements stored big endian
+#define VIDEO_MEMORY_MASK			(VIDEO_MEMORY_SIZE-1)
+
+#define GENERAL_RAM_START			0x000000
+#define TILE_RAM_START				0x200000
+#define TILE_FOREGROUND_COLOR_RAM_START		0x400000
+#define TILE_BACKGROUND_COLOR_RAM_START		0x600000
+#define PIXEL_RAM_START				0x800000
+
 #define	GENERAL_RAM_ELEMENTS_MASK		(GENERAL_RAM_ELEMENTS-1)
 #define TILE_RAM_ELEMENTS_MASK			(TILE_RAM_ELEMENTS-1)
 #define TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK	(TILE_FOREGROUND_COLOR_RAM_ELEMENTS-1)
 #define TILE_BACKGROUND_COLOR_RAM_ELEMENTS_MASK	(TILE_BACKGROUND_COLOR_RAM_ELEMENTS-1)
 #define PIXEL_RAM_ELEMENTS_MASK			(PIXEL_RAM_ELEMENTS-1)
 
+#define OPERATIONS_MIN				256
+#define OPERATIONS_MAX				65536
+
+#define BLIT_CACHE_MAX_BYTES			0x1000000	// 16mb
+
+#define PIPELINE_BLOCK_LOG2			13		// 8kb, the step of a blit in tile ram
+
+#define GLYPH_CACHE_ENTRIES_LOG2		12
+#define GLYPH_CACHE_ENTRIES			(1 << GLYPH_CACHE_ENTRIES_LOG2)
+
 #include "blit.hpp"
 #include "exceptions.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace E64
 {
 
+class mmu_ic;
+
 enum operation_type {
 	CLEAR,
 	HOR_BORDER,
@@ -94,11 +151,49 @@ enum operation_type {
 	BLIT
 };
 
+/*
+ * Render descriptor, a snapshot of only those properties of a blit_t
+ * that are needed to draw it. Together with its type, an operation
+ * fits in one cache line.
+ */
+struct blit_descriptor_t {
+	uint8_t  number;
+	uint8_t  kernel_flags;		// see BLIT_KERNEL_* in blitter.cpp
+
+	bool     color_per_tile;
+	bool     use_cbm_font;
+	bool     hor_flip;
+	bool     ver_flip;
+	bool     rotate;
+
+	uint8_t  width_in_tiles_log2;
+	uint8_t  height_in_tiles_log2;
+	uint8_t  tile_width_log2;
+	uint8_t  tile_height_log2;
+	uint8_t  width_on_screen_log2;
+
+	uint16_t tile_width_mask;
+	uint16_t tile_height_mask;
+	uint16_t width_on_screen;
+	uint16_t height_on_screen;
+
+	uint16_t foreground_color;
+	uint16_t background_color;
+
+	int16_t  x_pos;
+	int16_t  y_pos;
+
+	uint16_t origin;
+	uint16_t tiles_mask;
+};
+
 struct operation {
 	enum operation_type type;
-	blit_t blit;
+	struct blit_descriptor_t blit;
 };
 
+static_assert(sizeof(struct operation) <= 64, "operation must fit in a cache line");
+
 enum fsm_blitter_state_t {
 	FSM_IDLE,
 	FSM_CLEARING,
@@ -115,12 +210,83 @@ private:
 	bool generate_screenrefresh_irq;
 	exceptions_ic *exceptions;
 
-	// video ram, different components
-	uint8_t  *general_ram;			// 2mb
-	uint8_t  *tile_ram;			// 2mb
-	uint16_t *tile_foreground_color_ram;	// 2mb
-	uint16_t *tile_background_color_ram;	// 2mb
-	uint16_t *pixel_ram;			// 8mb
+	/*
+	 * Video ram, one block of 16mb containing general ram, tile ram,
+	 * tile foreground and background color ram and pixel ram. Just
+	 * like the cpu sees it, 16 bit values are big endian.
+	 */
+	uint8_t  *video_memory;
+
+	inline uint16_t video_memory_read_16(uint32_t address)
+	{
+		return (video_memory[address] << 8) | video_memory[address + 1];
+	}
+
+	inline void video_memory_write_16(uint32_t address, uint16_t value)
+	{
+		pipeline_protect(address);
+		touch_video_memory(address);
+		video_memory[address] = value >> 8;
+		video_memory[address + 1] = value & 0xff;
+		if (mmu) {
+			invalidate_code(address);
+			invalidate_code(address + 1);
+		}
+	}
+
+	/*
+	 * With an mmu connected, the cpu may run code from any part of
+	 * video memory. Each write is reported, so its predecoded
+	 * instructions don't go stale.
+	 */
+	mmu_ic *mmu;
+	void invalidate_code(uint32_t address);
+
+	/*
+	 * Addresses of individual elements in video memory
+	 */
+	inline uint32_t tile_address(uint32_t element)
+	{
+		return TILE_RAM_START | (element & TILE_RAM_ELEMENTS_MASK);
+	}
+
+	inline uint32_t tile_fg_color_address(uint32_t element)
+	{
+		return TILE_FOREGROUND_COLOR_RAM_START | ((element & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK) << 1);
+	}
+
+	inline uint32_t tile_bg_color_address(uint32_t element)
+	{
+		return TILE_BACKGROUND_COLOR_RAM_START | ((element & TILE_BACKGROUND_COLOR_RAM_ELEMENTS_MASK) << 1);
+	}
+
+	inline uint32_t pixel_address(uint32_t element)
+	{
+		return PIXEL_RAM_START | ((element & PIXEL_RAM_ELEMENTS_MASK) << 1);
+	}
+
+	/*
+	 * Tile (element) of a position in a terminal, taking the origin
+	 * into account. Positions outside the terminal are left alone.
+	 */
+	inline uint16_t terminal_tile(uint8_t number, uint16_t position)
+	{
+		uint16_t mask = blit[number].tiles - 1;
+		return (position & ~mask) | ((position + blit[number].origin) & mask);
+	}
+
+	/*
+	 * Content version per blit, bumped by any write into its window
+	 * of tile ram, tile color ram (8kb each) or pixel ram (32kb).
+	 */
+	uint32_t blit_version[256];
+
+	inline void touch_video_memory(uint32_t address)
+	{
+		if (address >= TILE_RAM_START) {
+			blit_version[((address >= PIXEL_RAM_START) ? (address >> 15) : (address >> 13)) & 0xff]++;
+		}
+	}
 
 	uint16_t *cbm_font;	// pointer to unpacked font
 
@@ -149,61 +315,267 @@ private:
 	uint8_t  blitter_context_5;
 	uint8_t  blitter_context_6;
 
+	/*
+	 * Display list
+	 */
+	uint32_t display_list;
+	bool     display_list_on_refresh;
+
 	enum fsm_blitter_state_t fsm_blitter_state;
 
 	inline void check_new_operation();
 
 	/*
-	 * Circular buffer containing max 65536 operations. If more
-	 * operations would be written (unlikely) and unfinished, buffer
-	 * will overwrite itself.
+	 * Circular buffer of operations, its size is a power of two.
+	 * Head and tail count operations and are masked into the buffer.
+	 * When full, the buffer doubles up to OPERATIONS_MAX entries.
+	 * Beyond that, new operations are dropped and counted.
 	 */
-	struct operation operations[65536];
-	uint16_t head;
-	uint16_t tail;
+	std::vector<struct operation> operations;
+	uint32_t operations_mask;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t operations_dropped;
+
+	bool make_room_for_operation();
+	inline struct operation *new_operation()
+	{
+		return make_room_for_operation() ? &operations[head++ & operations_mask] : nullptr;
+	}
 
 	/*
 	 * Finite state machine
 	 */
-	blit_t   *fsm_current_blit;
+	const struct blit_descriptor_t *fsm_current_blit;
 
 	uint32_t fsm_total_no_of_pix;		// total number of pixels to blit onto framebuffer for current blit
 	uint32_t pixel;				// current pixel of the total that is being processed
-	uint32_t fsm_normalized_pixel_no;	// normalized to the dimensions of source
 
 	/*
-	 *
+	 * True when all pixels of fb have alpha 0x0, so a compositor can
+	 * skip it. Any operation that may leave a visible pixel behind
+	 * resets it, only a completed clear with a transparent color
+	 * sets it.
 	 */
-	uint16_t fsm_temp_x;
-	uint16_t fsm_temp_y;
-	uint16_t fsm_temp_holder;
-	
-	uint16_t fsm_scrn_x;            // final screen x for the current pixel
-	uint16_t fsm_scrn_y;            // final screen y for the current pixel
+	bool     fb_transparent;
+	bool     fsm_clear_transparent;
+
+	/*
+	 * Span engine. Per blit operation (and band of scanlines) the
+	 * visible columns and rows (in on screen blit coordinates, so
+	 * before flips and rotation) are calculated, together with the
+	 * framebuffer index of pixel (0,0) and the steps to take for a
+	 * next column or row.
+	 */
+	struct blit_clip_t {
+		uint32_t column_start;
+		uint32_t column_end;
+		uint32_t row_start;
+		uint32_t row_end;
 
-	uint16_t x_in_blit;
-	uint16_t y_in_blit;
+		int32_t  fb_origin;
+		int32_t  fb_column_step;
+		int32_t  fb_row_step;
+	};
+
+	void calculate_blit_clipping(const struct blit_descriptor_t *b, int32_t first_scanline,
+				     int32_t last_scanline, struct blit_clip_t *clip);
+
+	/*
+	 * Blit kernels, one for each combination of the flags that are
+	 * tested per pixel (see BLIT_KERNEL_* in blitter.cpp). Flips and
+	 * rotation are already part of the framebuffer steps above. The
+	 * right kernel is selected once per blit operation.
+	 */
+	typedef void (blitter_ic::*blit_kernel_t)(const struct blit_descriptor_t *b, const struct blit_clip_t *clip,
+						  uint32_t row, uint32_t column, uint32_t column_end);
 
-	uint16_t tile_x;
-	uint16_t tile_y;
+	template <uint8_t kernel_flags>
+	void blit_run(const struct blit_descriptor_t *b, const struct blit_clip_t *clip,
+		      uint32_t row, uint32_t column, uint32_t column_end);
 
-	uint16_t tile_number;
-	uint8_t  tile_index;
-	uint16_t current_background_color;
-	uint32_t pixel_in_tile;
+	static const blit_kernel_t blit_kernels[64];
+	blit_kernel_t fsm_blit_kernel;
 
-	uint16_t source_color;
+	template <uint8_t kernel_flags>
+	inline void blit_fetch(const struct blit_descriptor_t *b, uint32_t row,
+			       uint32_t column, uint32_t column_end, uint16_t *run);
+
+	typedef void (blitter_ic::*blit_fetcher_t)(const struct blit_descriptor_t *b, uint32_t row,
+						   uint32_t column, uint32_t column_end, uint16_t *run);
+	static const blit_fetcher_t blit_fetchers[16];
+
+	void draw_run(const struct blit_clip_t *clip, uint32_t row, uint32_t column,
+		      const uint16_t *run, uint32_t run_length);
+
+	/*
+	 * Pixels of a cbm font tile with foreground and background
+	 * colors resolved (see blit_fetch), row after row.
+	 */
+	const uint16_t *cbm_glyph(uint8_t tile_index, uint16_t foreground_color,
+				  uint16_t background_color, const struct blit_descriptor_t *b,
+				  uint8_t kernel_flags);
+
+	/*
+	 * Blit cache, one entry per blit number with its unstretched
+	 * source colors. It is valid as long as the key and the content
+	 * version of the blit are the same. Entries in use by jobs of
+	 * the current run (batch) are never changed.
+	 */
+	struct blit_cache_key_t {
+		uint8_t  kernel_flags;		// without stretching
+		uint8_t  width_log2;
+		uint8_t  tile_width_log2;
+		uint8_t  tile_height_log2;
+		uint16_t height;
+		uint16_t foreground_color;
+		uint16_t background_color;
+		uint16_t origin;
+
+		inline bool operator==(const struct blit_cache_key_t &k) const
+		{
+			return	(kernel_flags == k.kernel_flags) &&
+				(width_log2 == k.width_log2) &&
+				(tile_width_log2 == k.tile_width_log2) &&
+				(tile_height_log2 == k.tile_height_log2) &&
+				(height == k.height) &&
+				(foreground_color == k.foreground_color) &&
+				(background_color == k.background_color) &&
+				(origin == k.origin);
+		}
+	};
+
+	enum blit_cache_state_t {
+		BLIT_CACHE_EMPTY,
+		BLIT_CACHE_SEEN,	// key and version known, not rasterized
+		BLIT_CACHE_FILLED
+	};
+
+	struct blit_cache_t {
+		enum blit_cache_state_t state;
+		struct blit_cache_key_t key;
+		uint32_t version;
+		uint32_t batch;
+		std::vector<uint16_t> pixels;
+	};
+
+	struct blit_cache_t blit_cache[256];
+	uint32_t blit_cache_batch;
+	size_t   blit_cache_bytes;
+	bool     fsm_blit_cached;
+
+	template <uint8_t kernel_flags>
+	void blit_run_cached(const struct blit_descriptor_t *b, const struct blit_clip_t *clip,
+			     uint32_t row, uint32_t column, uint32_t column_end);
+	static const blit_kernel_t blit_cached_kernels[4];
+
+	bool blit_cacheable(const struct blit_descriptor_t *b);
+	void blit_cache_key(const struct blit_descriptor_t *b, struct blit_cache_key_t *key);
+	void blit_cache_release(struct blit_cache_t *c);
+	bool blit_cache_fill(const struct blit_descriptor_t *b, struct blit_cache_t *c);
+	bool blit_cache_lookup(const struct blit_descriptor_t *b);
+
+	/*
+	 * The state machine only decides what gets drawn within the
+	 * cycle budget. Drawing is done by jobs: a number of pixels of
+	 * one operation, together with colors and sizes valid at that
+	 * moment.
+	 */
+	struct job_t {
+		enum operation_type type;
+		const struct blit_descriptor_t *blit;
+		blit_kernel_t kernel;
+		uint32_t first_pixel;
+		uint32_t no_of_pixels;
+		uint16_t color;
+		uint8_t  border_size;
+	};
+
+	void add_job(enum operation_type type, uint32_t count);
+	void execute_job(const struct job_t *job, uint32_t first_scanline, uint32_t last_scanline);
+
+	/*
+	 * Band parallel mode. The framebuffer is split into horizontal
+	 * bands, one per thread (the calling thread does band 0). Jobs
+	 * of a run are collected and each thread replays all of them,
+	 * clipped to its own band, so drawing order within a band stays
+	 * the same. With less than two threads jobs execute directly.
+	 */
+	int no_of_bands;
+	std::vector<struct job_t> jobs;
+	std::vector<std::thread> workers;
+	std::mutex workers_mutex;
+	std::condition_variable workers_start;
+	std::condition_variable workers_done;
+	uint32_t workers_generation;
+	int workers_busy;
+	bool workers_quit;
+
+	void worker(int band, uint32_t generation);
+	void execute_band(int band);
+	void execute_jobs();
+	void stop_workers();
+
+	/*
+	 * Pipelined mode. Jobs planned in run() are drawn into fb_draw
+	 * by the pipeline thread while the cpu executes the next frame.
+	 * The next run() waits for them and swaps fb_draw with fb, so
+	 * fb is a finished frame, one frame later than without
+	 * pipelining. Jobs only refer to blits in the operations ring
+	 * (which are copies), the 8kb blocks of video memory they read
+	 * from are marked in pipeline_blocks. A write into one of those
+	 * blocks waits for the pipeline first. Blocks are as small as the
+	 * tile and color ram of a single blit, so writes for other blits
+	 * (or parts of pixel ram a blit doesn't use) don't wait.
+	 */
+	bool     pipelined;
+	uint16_t *fb_draw;
+	bool     fb_front_transparent;
+	bool     pipeline_transparent;	// fb_transparent of the frame being drawn
+	bool     pipeline_pending;	// drawn, but not swapped yet
+	bool     pipeline_copy_front;	// fb_draw needs the contents of fb first
+	uint32_t pipeline_first_operation;	// oldest operation jobs refer to
+	uint8_t  pipeline_blocks[VIDEO_MEMORY_SIZE >> PIPELINE_BLOCK_LOG2];
+
+	std::thread pipeline_thread;
+	std::mutex pipeline_mutex;
+	std::condition_variable pipeline_start;
+	std::condition_variable pipeline_done;
+	std::atomic<bool> pipeline_busy;
+	bool pipeline_quit;
+
+	void pipeline_worker();
+	void pipeline_wait();
+	void pipeline_launch();
+	void pipeline_stop();
+	void pipeline_mark(uint32_t region_start, uint32_t region_size, uint32_t offset, uint32_t size);
+	void pipeline_mark_blit(const struct blit_descriptor_t *b);
+
+	inline void pipeline_protect(uint32_t address)
+	{
+		if (pipeline_busy.load(std::memory_order_acquire) &&
+		    pipeline_blocks[(address & VIDEO_MEMORY_MASK) >> PIPELINE_BLOCK_LOG2]) {
+			pipeline_wait();
+		}
+	}
 public:
-	blitter_ic();
+	/*
+	 * Without fill_pattern video memory starts zeroed (e.g. for the
+	 * hud, which uses a small part of it only).
+	 */
+	blitter_ic(bool fill_pattern = true);
 	~blitter_ic();
 	
 	uint8_t irq_number;
 	
 	void connect_exceptions_ic(exceptions_ic *exceptions_unit);
+	void connect_mmu_ic(mmu_ic *mmu_unit);
 
 	// framebuffer pointer
 	uint16_t *fb;
 
+	inline bool fb_is_transparent() { return pipelined ? fb_front_transparent : fb_transparent; }
+
 	/*
 	 * This method is called to notify blitter that screen was
 	 * just refreshed, so it has the possibility to raise an
@@ -234,85 +606,59 @@ public:
 		io_blit_context_write_8((address & 0x1fe0) >> 5, address & 0x1f, byte);
 	}
 
+	/*
+	 * Returns a host pointer to video memory at address, used by the
+	 * mmu for its page table.
+	 */
+	inline uint8_t *video_memory_host_pointer(uint32_t address)
+	{
+		return &video_memory[address & VIDEO_MEMORY_MASK];
+	}
+
 	inline uint8_t video_memory_read_8(uint32_t address)
 	{
-		switch ((address & 0x00e00000) >> 21) {
-			case 0b000:
-				/*
-				 * General ram
-				 */
-				return general_ram[address & GENERAL_RAM_ELEMENTS_MASK];
-			case 0b001:
-				return tile_ram[address & TILE_RAM_ELEMENTS_MASK];
-			case 0b010:
-				if (address & 0b1) {
-					return tile_foreground_color_ram[(address & 0x1fffff) >> 1] & 0x00ff;
-				} else {
-					return (tile_foreground_color_ram[(address & 0x1fffff) >> 1] & 0xff00) >> 8;
-				}
-			case 0b011:
-				if (address & 0b1) {
-					return tile_background_color_ram[(address & 0x1fffff) >> 1] & 0x00ff;
-				} else {
-					return (tile_background_color_ram[(address & 0x1fffff) >> 1] & 0xff00) >> 8;
-				}
-			case 0b100:
-			case 0b101:
-			case 0b110:
-			case 0b111:
-				/*
-				 * Pixel ram
-				 */
-				if (address & 0b1) {
-					return pixel_ram[(address & 0x7fffff) >> 1] & 0x00ff;
-				} else {
-					return (pixel_ram[(address & 0x7fffff) >> 1] & 0xff00) >> 8;
-				}
-		}
-		return 0;
+		return video_memory[address & VIDEO_MEMORY_MASK];
 	}
 
+	/*
+	 * Writes to anything but general ram must come through here (the
+	 * mmu has no host pointers for those pages).
+	 */
 	inline void video_memory_write_8(uint32_t address, uint8_t value)
 	{
-		switch ((address & 0x00e00000) >> 21) {
-			case 0b000:
-				general_ram[address & 0x1fffff] = value;
-				break;
-			case 0b001:
-				tile_ram[address & 0x1fffff] = value;
-				break;
-			case 0b010:
-				if (address & 0b1) {
-					tile_foreground_color_ram[(address & 0x1fffff) >> 1] = (tile_foreground_color_ram[(address & 0x1fffff) >> 1] & 0xff00) | value;
-				} else {
-					tile_foreground_color_ram[(address & 0x1fffff) >> 1] = (tile_foreground_color_ram[(address & 0x1fffff) >> 1] & 0x00ff) | (value << 8);
-				}
-				break;
-			case 0b011:
-				if (address & 0b1) {
-					tile_background_color_ram[(address & 0x1fffff) >> 1] = (tile_background_color_ram[(address & 0x1fffff) >> 1] & 0xff00) | value;
-				} else {
-					tile_background_color_ram[(address & 0x1fffff) >> 1] = (tile_background_color_ram[(address & 0x1fffff) >> 1] & 0x00ff) | (value << 8);
-				}
-				break;
-			case 0b100:
-			case 0b101:
-			case 0b110:
-			case 0b111:
-				if (address & 0b1) {
-					pixel_ram[(address & 0x7fffff) >> 1] = (pixel_ram[(address & 0x7fffff) >> 1] & 0xff00) | value;
-				} else {
-					pixel_ram[(address & 0x7fffff) >> 1] = (pixel_ram[(address & 0x7fffff) >> 1] & 0x00ff) | (value << 8);
-				}
-				break;
+		address &= VIDEO_MEMORY_MASK;
+		pipeline_protect(address);
+		touch_video_memory(address);
+		video_memory[address] = value;
+		if (mmu) invalidate_code(address);
+	}
 
-		}
+	/*
+	 * Waits until the pipeline has drawn all planned jobs.
+	 */
+	inline void sync()
+	{
+		if (pipeline_busy.load(std::memory_order_acquire)) pipeline_wait();
 	}
 
 	void reset();
 
 	void run(int no_of_cycles);
 
+	/*
+	 * Number of threads to draw with (band parallel), 0 or 1 means
+	 * drawing on the calling thread only.
+	 */
+	void set_threads(int no_of_threads);
+	inline int get_threads() { return no_of_bands; }
+
+	/*
+	 * Draw the jobs of a run() on a separate thread, concurrently
+	 * with whatever comes after it (see pipelined above).
+	 */
+	void set_pipelined(bool value);
+	inline bool get_pipelined() { return pipelined; }
+
 	struct blit_t *blit;
 
 	void set_clear_color(uint16_t color);
@@ -324,6 +670,20 @@ public:
 	void add_operation_draw_ver_border();
 	void add_operation_draw_blit(blit_t *blit);
 
+	/*
+	 * Render descriptors, from a blit context or from a display list
+	 * entry at the given video memory address
+	 */
+	void describe_blit(const blit_t *blit, struct blit_descriptor_t *d);
+	void describe_display_list_blit(uint32_t entry, struct blit_descriptor_t *d);
+
+	/*
+	 * Adds the operations of the display list at display_list
+	 */
+	void run_display_list();
+
+	inline uint32_t get_operations_dropped() { return operations_dropped; }
+
 	inline bool busy() { return fsm_blitter_state == FSM_IDLE ? false : true; }
 
 	/*
@@ -12,42 +12,42 @@
 
 void E64::blitter_ic::terminal_set_tile(uint8_t number, uint16_t cursor_position, char symbol)
 {
-	tile_ram[((number << 13) + cursor_position) & TILE_RAM_ELEMENTS_MASK] = symbol;
+	video_memory_write_8(tile_address((number << 13) + terminal_tile(number, cursor_position)), symbol);
 }
 
 void E64::blitter_ic::terminal_set_tile_fg_color(uint8_t number, uint16_t cursor_position, uint16_t color)
 {
-	tile_foreground_color_ram[((number << 12) + cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK] = color;
+	video_memory_write_16(tile_fg_color_address((number << 12) + terminal_tile(number, cursor_position)), color);
 }
 
 void E64::blitter_ic::terminal_set_tile_bg_color(uint8_t number, uint16_t cursor_position, uint16_t color)
 {
-	tile_background_color_ram[((number << 12) + cursor_position) & TILE_BACKGROUND_COLOR_RAM_ELEMENTS_MASK] = color;
+	video_memory_write_16(tile_bg_color_address((number << 12) + terminal_tile(number, cursor_position)), color);
 }
 
 uint8_t E64::blitter_ic::terminal_get_tile(uint8_t number, uint16_t cursor_position)
 {
-	return tile_ram[((number << 13) + cursor_position) & TILE_RAM_ELEMENTS_MASK];
+	return video_memory[tile_address((number << 13) + terminal_tile(number, cursor_position))];
 }
 
 uint16_t E64::blitter_ic::terminal_get_tile_fg_color(uint8_t number, uint16_t cursor_position)
 {
-	return tile_foreground_color_ram[((number << 12) + cursor_position) & TILE_FOREGROUND_COLOR_RAM_ELEMENTS_MASK];
+	return video_memory_read_16(tile_fg_color_address((number << 12) + terminal_tile(number, cursor_position)));
 }
 
 uint16_t E64::blitter_ic::terminal_get_tile_bg_color(uint8_t number, uint16_t cursor_position)
 {
-	return tile_background_color_ram[((number << 12) + cursor_position) & TILE_BACKGROUND_COLOR_RAM_ELEMENTS_MASK];
+	return video_memory_read_16(tile_bg_color_address((number << 12) + terminal_tile(number, cursor_position)));
 }
 
 void E64::blitter_ic::set_pixel(uint8_t number, uint32_t pixel_no, uint16_t color)
 {
-	pixel_ram[((number << 14) + pixel_no) & PIXEL_RAM_ELEMENTS_MASK] = color;
+	video_memory_write_16(pixel_address((number << 14) + pixel_no), color);
 }
 
 uint16_t E64::blitter_ic::get_pixel(uint8_t number, uint32_t pixel_no)
 {
-	return pixel_ram[((number << 14) + pixel_no) & PIXEL_RAM_ELEMENTS_MASK];
+	return video_memory_read_16(pixel_address((number << 14) + pixel_no));
 }
 
 void E64::blitter_ic::terminal_init(uint8_t number, uint8_t flags_0, uint8_t flags_1,
@@ -73,6 +73,8 @@ void E64::blitter_ic::terminal_init(uint8_t number, uint8_t flags_0, uint8_t fla
 
 void E64::blitter_ic::terminal_clear(uint8_t number)
 {
+	blit[number].origin = 0;
+
 	for (size_t i=0; i < blit[number].tiles; i++) {
 		terminal_set_tile(number, i, ' ');
 		terminal_set_tile_fg_color(number, i, blit[number].foreground_color);
@@ -296,14 +298,16 @@ char *E64::blitter_ic::terminal_enter_command(uint8_t no)
 	return blit[no].command_buffer;
 }
 
+/*
+ * Called with the cursor just above the top row. Scrolls down by moving
+ * the origin one row back, the old bottom row becomes the new top row
+ * and is cleared.
+ */
 void E64::blitter_ic::terminal_add_top_row(uint8_t no)
 {
 	blit[no].cursor_position += blit[no].columns;
-	for (int i=blit[no].tiles-1; i >= (blit[no].cursor_position - blit[no].get_current_column()) + blit[no].columns; i--) {
-		terminal_set_tile(no, i, terminal_get_tile(no, i - blit[no].columns));
-		terminal_set_tile_fg_color(no, i, terminal_get_tile_fg_color(no, i - blit[no].columns));
-		terminal_set_tile_bg_color(no, i, terminal_get_tile_bg_color(no, i - blit[no].columns));
-	}
+	blit[no].origin = (blit[no].origin - blit[no].columns) & (blit[no].tiles - 1);
+
 	uint16_t start_pos = blit[no].cursor_position - blit[no].get_current_column();
 	for (int i=0; i < blit[no].columns; i++) {
 		terminal_set_tile(no, start_pos, ASCII_SPACE);
@@ -313,16 +317,15 @@ void E64::blitter_ic::terminal_add_top_row(uint8_t no)
 	}
 }
 
+/*
+ * Scrolls up by moving the origin one row further, the old top row
+ * becomes the new bottom row and is cleared.
+ */
 void E64::blitter_ic::terminal_add_bottom_row(uint8_t no)
 {
-	uint16_t no_of_tiles_to_move = blit[no].tiles - blit[no].columns;
+	blit[no].origin = (blit[no].origin + blit[no].columns) & (blit[no].tiles - 1);
 
-	for (size_t i=0; i < no_of_tiles_to_move; i++) {
-		terminal_set_tile(no, i, terminal_get_tile(no, i + blit[no].columns));
-		terminal_set_tile_fg_color(no, i, terminal_get_tile_fg_color(no, i + blit[no].columns));
-		terminal_set_tile_bg_color(no, i, terminal_get_tile_bg_color(no, i + blit[no].columns));
-	}
-	for (size_t i=no_of_tiles_to_move; i < blit[no].tiles; i++) {
+	for (size_t i=blit[no].tiles - blit[no].columns; i < blit[no].tiles; i++) {
 		terminal_set_tile(no, i, ' ');
 		terminal_set_tile_fg_color(no, i, blit[no].foreground_color);
 		terminal_set_tile_bg_color(no, i, blit[no].background_color);
@@ -225,15 +225,16 @@ inline char event_to_ascii(uint8_t scancode, uint8_t modifiers)
     return 0;
 }
 
-E64::cia_ic::cia_ic()
+E64::cia_ic::cia_ic(scheduler_t *clock)
 {
+    scheduler = clock;
     cycles_per_interval = CPU_CLOCK_SPEED / 100; // no of cycles @ cpu clockspeed for a total of 10 ms
     reset();
 }
 
 void E64::cia_ic::reset()
 {
-    cycle_counter = 0;
+    scheduler->schedule_in(EVENT_CIA, cycles_per_interval);
     
     for(int i=0; i<256; i++) registers[i] = 0x00;
     //for(int i=0; i<128; i++) sdl2_keys_last_known_state[i] = 0x00;
@@ -273,56 +274,52 @@ uint8_t E64::cia_ic::pop_event()
     return result;
 }
 
-void E64::cia_ic::run(int no_of_cycles)
+void E64::cia_ic::event()
 {
-	cycle_counter += no_of_cycles;
-    
-	if (cycle_counter >= cycles_per_interval) {
-		cycle_counter -= cycles_per_interval;
-        
-		// check modifier keys
-		uint8_t modifier_keys_status =  (sdl2_keys_last_known_state[SCANCODE_LSHIFT] ? SHIFT_PRESSED : 0) |
-						(sdl2_keys_last_known_state[SCANCODE_RSHIFT] ? SHIFT_PRESSED : 0) |
-						(sdl2_keys_last_known_state[SCANCODE_LCTRL ] ? CTRL_PRESSED  : 0) |
-						(sdl2_keys_last_known_state[SCANCODE_RCTRL ] ? CTRL_PRESSED  : 0);
+	scheduler->schedule(EVENT_CIA, scheduler->deadline(EVENT_CIA) + cycles_per_interval);
+	
+	// check modifier keys
+	uint8_t modifier_keys_status =  (sdl2_keys_last_known_state[SCANCODE_LSHIFT] ? SHIFT_PRESSED : 0) |
+					(sdl2_keys_last_known_state[SCANCODE_RSHIFT] ? SHIFT_PRESSED : 0) |
+					(sdl2_keys_last_known_state[SCANCODE_LCTRL ] ? CTRL_PRESSED  : 0) |
+					(sdl2_keys_last_known_state[SCANCODE_RCTRL ] ? CTRL_PRESSED  : 0);
         
-		// registers 128 to 255 reflect the current keyboard state
-		// shift each register one bit to the left, bit 0 is only set if key is pressed
-		// if one of the keys changed its state, push an event
-		for (int i=0x00; i<0x80; i++) {
-			registers[0x80 | i] = (registers[0x80 | i] << 1) | sdl2_keys_last_known_state[i];
+	// registers 128 to 255 reflect the current keyboard state
+	// shift each register one bit to the left, bit 0 is only set if key is pressed
+	// if one of the keys changed its state, push an event
+	for (int i=0x00; i<0x80; i++) {
+		registers[0x80 | i] = (registers[0x80 | i] << 1) | sdl2_keys_last_known_state[i];
 
-			switch (registers[0x80 | i] & 0b00000011) {
-				case 0b01:
-				    // Event: key pressed
-				    if (generating_key_events && scancode_not_modifier[i]) {
-					key_down = true;
-					last_key = i;
-					keyboard_repeat_current_max = keyboard_repeat_delay;
-					keyboard_repeat_counter = 0;
-				    }
-				    break;
-				case 0b10:
-				    // Event: key released
-				    if (generating_key_events) {
-					if (i == last_key)
-						key_down = false;
-				    }
-				    break;
-				default:
-				    // do nothing
-				    break;
-			}
+		switch (registers[0x80 | i] & 0b00000011) {
+			case 0b01:
+			    // Event: key pressed
+			    if (generating_key_events && scancode_not_modifier[i]) {
+				key_down = true;
+				last_key = i;
+				keyboard_repeat_current_max = keyboard_repeat_delay;
+				keyboard_repeat_counter = 0;
+			    }
+			    break;
+			case 0b10:
+			    // Event: key released
+			    if (generating_key_events) {
+				if (i == last_key)
+					key_down = false;
+			    }
+			    break;
+			default:
+			    // do nothing
+			    break;
 		}
+	}
         
-		if (key_down) {
-			if (keyboard_repeat_counter == 0)
-				push_event(event_to_ascii(last_key, modifier_keys_status));
-			keyboard_repeat_counter++;
-			if (keyboard_repeat_counter == keyboard_repeat_current_max) {
-				keyboard_repeat_counter = 0;
-				keyboard_repeat_current_max = keyboard_repeat_speed;
-			}
+	if (key_down) {
+		if (keyboard_repeat_counter == 0)
+			push_event(event_to_ascii(last_key, modifier_keys_status));
+		keyboard_repeat_counter++;
+		if (keyboard_repeat_counter == keyboard_repeat_current_max) {
+			keyboard_repeat_counter = 0;
+			keyboard_repeat_current_max = keyboard_repeat_speed;
 		}
 	}
 }
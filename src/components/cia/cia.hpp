@@ -36,6 +36,7 @@
  */
 
 #include <cstdint>
+#include "scheduler.hpp"
 
 #ifndef cia_hpp
 #define cia_hpp
@@ -120,7 +121,7 @@ enum scancodes
 
 class cia_ic {
 private:
-	uint32_t    cycle_counter;
+	scheduler_t *scheduler;
 	uint32_t    cycles_per_interval;
     
 	void    push_event(uint8_t event);
@@ -149,7 +150,7 @@ private:
 	}
 
 public:
-	cia_ic();
+	cia_ic(scheduler_t *clock);
     
 	/*
 	 * Reset, also called by constructor
@@ -158,8 +159,11 @@ public:
 
 	uint8_t registers[256];
     
-	/*  Run a number of cycles */
-	void run(int no_of_cycles);
+	/*
+	 * Keyboard scan, called by the owner of the scheduler on EVENT_CIA
+	 * (every 10ms)
+	 */
+	void event();
     
 	/*
 	 * Register access functions
@@ -167,6 +171,15 @@ public:
 	uint8_t io_read_byte(uint8_t address);
 	void io_write_byte(uint8_t address, uint8_t byte);
 	
+	/*
+	 * Only reading register 0x04 pops an event, which changes nothing
+	 * while the fifo is empty.
+	 */
+	inline bool io_read_side_effect_free(uint8_t address)
+	{
+		return (address != 0x04) || !events_waiting();
+	}
+	
 	/*
 	 * Convenience functions
 	 */
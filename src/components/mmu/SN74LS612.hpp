@@ -19,7 +19,23 @@ private:
 	 * Internal 12bit mem registers of mmu (only bits 12-23 used)
 	 */
 	uint32_t registers[16];
+
+	void check_aliases()
+	{
+		aliased = false;
+		for (int i=0; i<15; i++) {
+			for (int j=i+1; j<16; j++) {
+				if (registers[i] == registers[j]) aliased = true;
+			}
+		}
+	}
 public:
+	/*
+	 * True when two or more logical blocks point to the same
+	 * physical block.
+	 */
+	bool aliased;
+
 	/*
 	 * Each register contains a 12bit pointer to a 4kb block
 	 * in 16mb of ram (as seen from the mmu). After a reset,
@@ -28,6 +44,7 @@ public:
 	void reset()
 	{
 		for(int i=0; i<16; i++) registers[i] = i << 12;
+		aliased = false;
 	}
 
 	
@@ -55,12 +72,15 @@ public:
 				(registers[(address & 0x1f) >> 1] & 0x0000f000) |
 				(byte << 16);
 	    }
+		check_aliases();
 	}
 	
 	inline uint32_t logical_to_physical(uint16_t address)
 	{
 		return registers[address >> 12] | (address & 0x0fff);
 	}
+
+	inline uint32_t block(uint8_t no) { return registers[no & 0xf]; }
 };
 
 }
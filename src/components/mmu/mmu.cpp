@@ -8,20 +8,92 @@
 #include "mmu.hpp"
 #include "common.hpp"
 #include "rom.hpp"
+#include "mc6809_cpp.hpp"
 
 void E64::mmu_ic::reset()
 {
 	blit_registers_banked_in = true;
 	rom_banked_in = true;
 	
+	/*
+	 * Predecoding instructions from the io range or the banked in
+	 * blit registers would skip the side effects of reading them.
+	 */
+	for (int i=0x08; i<0x10; i++)
+		machine.cpu->predecode_set_cacheable(i, false);
+	for (int i=0xc0; i<0xe0; i++)
+		machine.cpu->predecode_set_cacheable(i, !blit_registers_banked_in);
+	
 	// if available, update rom image
 	update_rom_image();
+	update_pages();
+	machine.cpu->predecode_flush();
+}
+
+void E64::mmu_ic::update_pages()
+{
+	for (int i=0; i<256; i++) {
+		uint32_t physical = machine.SN74LS612->logical_to_physical(i << 8);
+		uint8_t *ram = machine.blitter->video_memory_host_pointer(physical);
+		
+		pages[i].read = ram;
+		pages[i].handler = PAGE_VIDEO_RAM;
+		
+		/*
+		 * Writes into tile, color or pixel ram go through the
+		 * blitter, for its dirty tracking and pipeline.
+		 */
+		pages[i].write = ((physical & VIDEO_MEMORY_MASK) < TILE_RAM_START) ? ram : nullptr;
+		
+		if ((i & 0b11111000) == 0b00001000) {
+			// $0800 - $0fff io range ALWAYS visible
+			switch (i) {
+				case IO_BLIT:
+					pages[i].handler = PAGE_BLIT;
+					break;
+				case IO_SOUND_PAGE:
+				case IO_MIXER_PAGE:
+					pages[i].handler = PAGE_SOUND;
+					break;
+				case IO_TIMER_PAGE:
+					pages[i].handler = PAGE_TIMER;
+					break;
+				case IO_CIA_PAGE:
+					pages[i].handler = PAGE_CIA;
+					break;
+				case IO_SN74LS612:
+					pages[i].handler = PAGE_SN74LS612;
+					break;
+				case IO_M68K_PAGE:
+					pages[i].handler = PAGE_M68K;
+					break;
+			}
+			if (pages[i].handler != PAGE_VIDEO_RAM) {
+				pages[i].read = nullptr;
+				pages[i].write = nullptr;
+			}
+		} else if (((i & 0b11100000) == 0b11000000) && blit_registers_banked_in) {
+			// $c000 - $dfff io blit registers (2 x 4 = 8kb)
+			pages[i].read = nullptr;
+			pages[i].write = nullptr;
+			pages[i].handler = PAGE_BLIT_CONTEXTS;
+		} else if (((i & 0b11100000) == 0b11100000) && rom_banked_in) {
+			// $e000 - $ffff rom, writes go to ram underneath
+			pages[i].read = &current_rom_image[(i << 8) & 0x1fff];
+		}
+		
+		/*
+		 * Native code of the cpu accesses the same pages directly,
+		 * except for the rom mirror in page 0 and writes that have
+		 * to be invalidated in more than one logical block.
+		 */
+		machine.cpu->jit_map_page(i, i ? pages[i].read : nullptr,
+					  machine.SN74LS612->aliased ? nullptr : pages[i].write);
+	}
 }
 
 uint8_t E64::mmu_ic::read_memory_8(uint16_t address)
 {
-	uint16_t page = address >> 8;
-	
 	/*
 	 * Mirror first 8 bytes in memory to first 8 bytes from current rom.
 	 * Respectively inital SSP and PC.
@@ -30,73 +102,117 @@ uint8_t E64::mmu_ic::read_memory_8(uint16_t address)
 		return current_rom_image[address & 0x7];
 	}
 	
-	if ((page & 0b11111000) == 0b00001000) {
-		switch (page) {
-			// $0800 - $0fff io range ALWAYS visible
-			case IO_BLIT:
-				return machine.blitter->io_read_8(address & 0xff);
-			case IO_SOUND_PAGE:
-				return machine.sound->read_byte(address & 0x1ff);
-			case IO_MIXER_PAGE:
-				return machine.sound->read_byte(address & 0x1ff);
-			case IO_TIMER_PAGE:
-				return machine.timer->io_read_byte(address & 0xff);
-			case IO_CIA_PAGE:
-				return machine.cia->io_read_byte(address & 0xff);
-			case IO_SN74LS612:
-				return machine.SN74LS612->read_byte(address & 0xff);
-			default:
-				return machine.blitter->video_memory_read_8(machine.SN74LS612->logical_to_physical(address & 0xffff));
-		}
-	} else if (((page & 0b11100000) == 0b11000000) && blit_registers_banked_in) {
-		// $c000 - $dfff io blit registers (2 x 4 = 8kb)
-		// for now:
-		return machine.blitter->io_blit_contexts_read_8(address);
-	} else if (((page & 0b11100000) == 0b11100000) && rom_banked_in) {
-		// $e000 - $ffff rom
-		return current_rom_image[address & 0x1fff];
-	} else {
-		// now it's ram
-		return machine.blitter->video_memory_read_8(machine.SN74LS612->logical_to_physical(address & 0xffff));
+	uint8_t *page = pages[address >> 8].read;
+	
+	return page ? page[address & 0xff] : read_handler(address);
+}
+
+bool E64::mmu_ic::side_effect_free(void *mmu, uint16_t address)
+{
+	switch (((mmu_ic *)mmu)->pages[address >> 8].handler) {
+		case PAGE_VIDEO_RAM:
+		case PAGE_M68K:
+			return true;
+		case PAGE_CIA:
+			return machine.cia->io_read_side_effect_free(address & 0xff);
+		default:
+			return false;
 	}
 }
 
 void E64::mmu_ic::write_memory_8(uint16_t address, uint8_t value)
 {
-	uint16_t page = address >> 8;
+	uint8_t *page = pages[address >> 8].write;
 	
-	if ((page & 0b11111000) == 0b00001000) {
-		switch (page) {
-			// $0800 - $0fff io range will ALWAYS be written to
-			case IO_BLIT:
-				machine.blitter->io_write_8(address & 0xff, value);
-				break;
-			case IO_SOUND_PAGE:
-				machine.sound->write_byte(address & 0x1ff, value & 0xff);
-				break;
-			case IO_MIXER_PAGE:
-				machine.sound->write_byte(address & 0x1ff, value & 0xff);
-				break;
-			case IO_TIMER_PAGE:
-				machine.timer->io_write_byte(address & 0xff, value & 0xff);
-				break;
-			case IO_CIA_PAGE:
-				machine.cia->io_write_byte(address & 0xff, value & 0xff);
-				break;
-			case IO_SN74LS612:
-				machine.SN74LS612->write_byte(address &0xff, value & 0xff);
-				break;
-			default:
-				// use ram
-				machine.blitter->video_memory_write_8(machine.SN74LS612->logical_to_physical(address & 0xffff), value & 0xff);
-				break;
+	if (page) {
+		page[address & 0xff] = value;
+		invalidate_predecoded(address);
+	} else {
+		write_handler(address, value);
+	}
+}
+
+uint8_t E64::mmu_ic::read_handler(uint16_t address)
+{
+	switch (pages[address >> 8].handler) {
+		case PAGE_BLIT:
+			return machine.blitter->io_read_8(address & 0xff);
+		case PAGE_SOUND:
+			return machine.sound->read_byte(address & 0x1ff);
+		case PAGE_TIMER:
+			return machine.timer->io_read_byte(address & 0xff);
+		case PAGE_CIA:
+			return machine.cia->io_read_byte(address & 0xff);
+		case PAGE_SN74LS612:
+			return machine.SN74LS612->read_byte(address & 0xff);
+		case PAGE_M68K:
+			return machine.m68k->io_read_byte(address & 0xff);
+		case PAGE_BLIT_CONTEXTS:
+			return machine.blitter->io_blit_contexts_read_8(address);
+		default:
+			return machine.blitter->video_memory_read_8(machine.SN74LS612->logical_to_physical(address));
+	}
+}
+
+void E64::mmu_ic::write_handler(uint16_t address, uint8_t value)
+{
+	switch (pages[address >> 8].handler) {
+		case PAGE_BLIT:
+			machine.blitter->io_write_8(address & 0xff, value);
+			break;
+		case PAGE_SOUND:
+			machine.sound->write_byte(address & 0x1ff, value);
+			break;
+		case PAGE_TIMER:
+			machine.timer->io_write_byte(address & 0xff, value);
+			break;
+		case PAGE_CIA:
+			machine.cia->io_write_byte(address & 0xff, value);
+			break;
+		case PAGE_SN74LS612:
+			machine.SN74LS612->write_byte(address & 0xff, value);
+			update_pages();
+			machine.cpu->predecode_flush();
+			break;
+		case PAGE_M68K:
+			machine.m68k->io_write_byte(address & 0xff, value);
+			break;
+		case PAGE_BLIT_CONTEXTS:
+			machine.blitter->io_blit_contexts_write_8(address, value);
+			break;
+		default:
+			// invalidates predecoded instructions itself
+			machine.blitter->video_memory_write_8(machine.SN74LS612->logical_to_physical(address), value);
+			break;
+	}
+}
+
+void E64::mmu_ic::invalidate_predecoded(uint16_t address)
+{
+	if (machine.SN74LS612->aliased) {
+		/*
+		 * Invalidate the byte in every logical block that points
+		 * to the same physical block.
+		 */
+		uint32_t block = machine.SN74LS612->block(address >> 12);
+		for (int i=0; i<16; i++) {
+			if (machine.SN74LS612->block(i) == block) {
+				machine.cpu->predecode_invalidate((i << 12) | (address & 0x0fff));
+			}
 		}
-	} else if (((page & 0b11100000) == 0b11000000) && blit_registers_banked_in) {
-		// $c000 - $dfff io blit registers (2 x 4 = 8kb)
-		machine.blitter->io_blit_contexts_write_8(address, value);
 	} else {
-		// now it's ram
-		machine.blitter->video_memory_write_8(machine.SN74LS612->logical_to_physical(address & 0xffff), value & 0xff);
+		machine.cpu->predecode_invalidate(address);
+	}
+}
+
+void E64::mmu_ic::invalidate_physical(uint32_t address)
+{
+	uint32_t block = address & 0xfff000;
+	
+	for (int i=0; i<16; i++) {
+		if (machine.SN74LS612->block(i) == block) {
+			machine.cpu->predecode_invalidate((i << 12) | (address & 0x0fff));
+		}
 	}
 }
 
@@ -168,3 +284,15 @@ bool E64::mmu_ic::insert_binary(char *file)
 		return false;
 	}
 }
+
+uint8_t E64::mmu_bus_t::read_8(uint16_t address)
+{
+	return machine.mmu->read_memory_8(address);
+}
+
+void E64::mmu_bus_t::write_8(uint16_t address, uint8_t byte)
+{
+	machine.mmu->write_memory_8(address, byte);
+}
+
+template class mc6809_t<E64::mmu_bus_t>;
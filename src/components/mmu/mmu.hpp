@@ -12,6 +12,7 @@
 #include <cstdlib>
 
 #define IO_BLIT		0x0008
+#define IO_M68K_PAGE	0x000a
 #define IO_TIMER_PAGE	0x000b
 #define IO_SOUND_PAGE	0x000c
 #define IO_MIXER_PAGE	0x000d
@@ -21,16 +22,67 @@
 namespace E64
 {
 
+enum page_handler_t : uint8_t {
+	PAGE_VIDEO_RAM,		// ram, normally through host pointers
+	PAGE_BLIT,
+	PAGE_TIMER,
+	PAGE_SOUND,
+	PAGE_CIA,
+	PAGE_SN74LS612,
+	PAGE_M68K,
+	PAGE_BLIT_CONTEXTS
+};
+
+/*
+ * One entry per 256 byte page of cpu memory. Pages that behave like
+ * memory have host pointers for reading and / or writing, a nullptr
+ * means the access goes through the handler.
+ */
+struct page_t {
+	uint8_t *read;
+	uint8_t *write;
+	enum page_handler_t handler;
+};
+
 class mmu_ic {
+private:
+	struct page_t pages[256];
+
+	uint8_t read_handler(uint16_t address);
+	void write_handler(uint16_t address, uint8_t value);
+
+	void invalidate_predecoded(uint16_t address);
 public:
 	void reset();
 	
+	/*
+	 * For writes into physical ram that don't come from the 6809 (the
+	 * blitter, the 68000), invalidates the byte in every logical block
+	 * that points to it.
+	 */
+	void invalidate_physical(uint32_t address);
+	
+	/*
+	 * After changing these flags, update_pages() must be called
+	 */
 	bool blit_registers_banked_in;
 	bool rom_banked_in;
 	
+	/*
+	 * Rebuilds the page table from the SN74LS612 registers and
+	 * banking flags.
+	 */
+	void update_pages();
+	
 	uint8_t read_memory_8(uint16_t address);
 	void write_memory_8(uint16_t address, uint8_t value);
 	
+	/*
+	 * True if reading address in the current state of the machine
+	 * has no side effects, for the idle loop detection of the cpu.
+	 */
+	static bool side_effect_free(void *mmu, uint16_t address);
+	
 	uint16_t read_memory_16(uint32_t address);
 	void write_memory_16(uint32_t address, uint16_t value);
 	
@@ -41,6 +93,17 @@ public:
 	bool insert_binary(char *file);
 };
 
+/*
+ * Bus policy of the MC6809. Its member functions are defined in mmu.cpp,
+ * which also instantiates the cpu, so the compiler can inline the memory
+ * paths of the mmu into the instruction handlers.
+ */
+class mmu_bus_t {
+public:
+	uint8_t read_8(uint16_t address);
+	void write_8(uint16_t address, uint8_t byte);
+};
+
 }
 
 #endif
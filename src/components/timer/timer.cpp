@@ -8,9 +8,10 @@
 #include "timer.hpp"
 #include "common.hpp"
 
-E64::timer_ic::timer_ic(exceptions_ic *unit)
+E64::timer_ic::timer_ic(exceptions_ic *unit, scheduler_t *clock)
 {
 	exceptions = unit;
+	scheduler = clock;
 	irq_number = exceptions->connect_device();
 }
 
@@ -29,22 +30,38 @@ void E64::timer_ic::reset()
 	for (int i=0; i<8; i++) {
 		timers[i].bpm = 0x0001; // load with 1, may never be zero
 		timers[i].clock_interval = bpm_to_clock_interval(timers[i].bpm);
-		timers[i].counter = 0;
+		timers[i].start = scheduler->now();
+		scheduler->cancel((event_t)(EVENT_TIMER0 + i));
 	}
 	
 	exceptions->release(irq_number);
 }
 
-void E64::timer_ic::run(uint32_t number_of_cycles)
+void E64::timer_ic::event(uint8_t timer_no)
 {
-	for (int i=0; i<8; i++) {
-		timers[i].counter += number_of_cycles;
-		if ((timers[i].counter >= timers[i].clock_interval) && (control_register & (0b1 << i))) {
-			while (timers[i].counter >= timers[i].clock_interval)
-				timers[i].counter -= timers[i].clock_interval;
-			exceptions->pull(irq_number);
-			status_register |= (0b1 << i);
-		}
+	timer_no &= 0b111;
+	
+	/*
+	 * Take out whole intervals only, the cycles the event was handled
+	 * late remain on the counter.
+	 */
+	uint64_t elapsed = scheduler->now() - timers[timer_no].start;
+	timers[timer_no].start += (elapsed / timers[timer_no].clock_interval) * timers[timer_no].clock_interval;
+	
+	exceptions->pull(irq_number);
+	status_register |= (0b1 << timer_no);
+	
+	reschedule(timer_no);
+}
+
+void E64::timer_ic::reschedule(uint8_t timer_no)
+{
+	event_t event = (event_t)(EVENT_TIMER0 + timer_no);
+	
+	if (control_register & (0b1 << timer_no)) {
+		scheduler->schedule(event, timers[timer_no].start + timers[timer_no].clock_interval);
+	} else {
+		scheduler->cancel(event);
 	}
 }
 
@@ -122,93 +139,113 @@ void E64::timer_ic::io_write_byte(uint8_t address, uint8_t byte)
 		case 0x01:
 		{
 			uint8_t turned_on = byte & (~control_register);
+			uint8_t changed = byte ^ control_register;
 			for (int i=0; i<8; i++) {
 				if (turned_on & (0b1 << i)) {
-					timers[i].counter = 0;
+					timers[i].start = scheduler->now();
 				}
 			}
 			control_register = byte;
+			for (int i=0; i<8; i++) {
+				if (changed & (0b1 << i)) reschedule(i);
+			}
 			break;
 		}
 		case 0x10:
 			timers[0].bpm = (timers[0].bpm & 0x00ff) | (byte << 8);
 			if (timers[0].bpm == 0) timers[0].bpm = 1;
 			timers[0].clock_interval = bpm_to_clock_interval(timers[0].bpm);
+			reschedule(0);
 			break;
 		case 0x11:
 			timers[0].bpm = (timers[0].bpm & 0xff00) | byte;
 			if (timers[0].bpm == 0) timers[0].bpm = 1;
 			timers[0].clock_interval = bpm_to_clock_interval(timers[0].bpm);
+			reschedule(0);
 			break;
 		case 0x12:
 			timers[1].bpm = (timers[1].bpm & 0x00ff) | (byte << 8);
 			if (timers[1].bpm == 0) timers[0].bpm = 1;
 			timers[1].clock_interval = bpm_to_clock_interval(timers[1].bpm);
+			reschedule(1);
 			break;
 		case 0x13:
 			timers[1].bpm = (timers[1].bpm & 0xff00) | byte;
 			if (timers[1].bpm == 0) timers[0].bpm = 1;
 			timers[1].clock_interval = bpm_to_clock_interval(timers[1].bpm);
+			reschedule(1);
 			break;
 		case 0x14:
 			timers[2].bpm = (timers[2].bpm & 0x00ff) | (byte << 8);
 			if (timers[2].bpm == 0) timers[0].bpm = 1;
 			timers[2].clock_interval = bpm_to_clock_interval(timers[2].bpm);
+			reschedule(2);
 			break;
 		case 0x15:
 			timers[2].bpm = (timers[2].bpm & 0xff00) | byte;
 			if (timers[2].bpm == 0) timers[0].bpm = 1;
 			timers[2].clock_interval = bpm_to_clock_interval(timers[2].bpm);
+			reschedule(2);
 			break;
 		case 0x16:
 			timers[3].bpm = (timers[3].bpm & 0x00ff) | (byte << 8);
 			if (timers[3].bpm == 0) timers[0].bpm = 1;
 			timers[3].clock_interval = bpm_to_clock_interval(timers[3].bpm);
+			reschedule(3);
 			break;
 		case 0x17:
 			timers[3].bpm = (timers[3].bpm & 0xff00) | byte;
 			if (timers[3].bpm == 0) timers[0].bpm = 1;
 			timers[3].clock_interval = bpm_to_clock_interval(timers[3].bpm);
+			reschedule(3);
 			break;
 		case 0x18:
 			timers[4].bpm = (timers[4].bpm & 0x00ff) | (byte << 8);
 			if (timers[4].bpm == 0) timers[0].bpm = 1;
 			timers[4].clock_interval = bpm_to_clock_interval(timers[4].bpm);
+			reschedule(4);
 			break;
 		case 0x19:
 			timers[4].bpm = (timers[4].bpm & 0xff00) | byte;
 			if (timers[4].bpm == 0) timers[0].bpm = 1;
 			timers[4].clock_interval = bpm_to_clock_interval(timers[4].bpm);
+			reschedule(4);
 			break;
 		case 0x1a:
 			timers[5].bpm = (timers[5].bpm & 0x00ff) | (byte << 8);
 			if (timers[5].bpm == 0) timers[0].bpm = 1;
 			timers[5].clock_interval = bpm_to_clock_interval(timers[5].bpm);
+			reschedule(5);
 			break;
 		case 0x1b:
 			timers[5].bpm = (timers[5].bpm & 0xff00) | byte;
 			if (timers[5].bpm == 0) timers[0].bpm = 1;
 			timers[5].clock_interval = bpm_to_clock_interval(timers[5].bpm);
+			reschedule(5);
 			break;
 		case 0x1c:
 			timers[6].bpm = (timers[6].bpm & 0x00ff) | (byte << 8);
 			if (timers[6].bpm == 0) timers[0].bpm = 1;
 			timers[6].clock_interval = bpm_to_clock_interval(timers[6].bpm);
+			reschedule(6);
 			break;
 		case 0x1d:
 			timers[6].bpm = (timers[6].bpm & 0xff00) | byte;
 			if (timers[6].bpm == 0) timers[0].bpm = 1;
 			timers[6].clock_interval = bpm_to_clock_interval(timers[6].bpm);
+			reschedule(6);
 			break;
 		case 0x1e:
 			timers[7].bpm = (timers[7].bpm & 0x00ff) | (byte << 8);
 			if (timers[7].bpm == 0) timers[0].bpm = 1;
 			timers[7].clock_interval = bpm_to_clock_interval(timers[7].bpm);
+			reschedule(7);
 			break;
 		case 0x1f:
 			timers[7].bpm = (timers[7].bpm & 0xff00) | byte;
 			if (timers[7].bpm == 0) timers[0].bpm = 1;
 			timers[7].clock_interval = bpm_to_clock_interval(timers[7].bpm);
+			reschedule(7);
 			break;
 		default:
 			// do nothing
@@ -218,7 +255,7 @@ void E64::timer_ic::io_write_byte(uint8_t address, uint8_t byte)
 
 uint64_t E64::timer_ic::get_timer_counter(uint8_t timer_number)
 {
-	return timers[timer_number & 0x07].counter;
+	return (uint32_t)(scheduler->now() - timers[timer_number & 0x07].start);
 }
 
 uint64_t E64::timer_ic::get_timer_clock_interval(uint8_t timer_number)
@@ -233,6 +270,7 @@ void E64::timer_ic::set(uint8_t timer_no, uint16_t bpm)
 	if (bpm == 0) bpm = 1;
 	timers[timer_no].bpm = bpm;
 	timers[timer_no].clock_interval = bpm_to_clock_interval(bpm);
+	reschedule(timer_no);
 	
 	uint8_t byte = io_read_byte(0x01);
 	io_write_byte(0x01, (0b1 << timer_no) | byte);
@@ -246,6 +284,6 @@ void E64::timer_ic::status(char *buffer, uint8_t timer_no)
 		 timer_no,
 		 control_register & (0b1 << timer_no) ? " on" : "off",
 		 timers[timer_no].bpm,
-		 timers[timer_no].counter,
+		 (uint32_t)get_timer_counter(timer_no),
 		 timers[timer_no].clock_interval);
 }
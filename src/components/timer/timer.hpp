@@ -55,6 +55,7 @@
 
 #include <cstdint>
 #include "exceptions.hpp"
+#include "scheduler.hpp"
 
 namespace E64
 {
@@ -63,8 +64,11 @@ struct timer_unit {
 	uint16_t bpm;
 	uint32_t clock_interval;
 	
-	// NEEDS WORK? used to be 64 bit...
-	uint32_t counter;
+	/*
+	 * Cycle at which the counter was zero. The counter itself is
+	 * derived from the scheduler clock when needed.
+	 */
+	uint64_t start;
 };
 
 class timer_ic
@@ -78,8 +82,11 @@ private:
 	uint32_t bpm_to_clock_interval(uint16_t bpm);
 	
 	exceptions_ic *exceptions;
+	scheduler_t *scheduler;
+	
+	void reschedule(uint8_t timer_no);
 public:
-	timer_ic(exceptions_ic *unit);
+	timer_ic(exceptions_ic *unit, scheduler_t *clock);
 	void reset();
 	
 	uint8_t irq_number;
@@ -92,8 +99,8 @@ public:
 	uint64_t get_timer_counter(uint8_t timer_number);
 	uint64_t get_timer_clock_interval(uint8_t timer_number);
 
-	// run cycles on this ic
-	void run(uint32_t number_of_cycles);
+	// called by the owner of the scheduler on EVENT_TIMER0 + timer_no
+	void event(uint8_t timer_no);
 	
 	// convenience function (turning on specific timer + bpm)
 	void set(uint8_t timer_no, uint16_t bpm);
@@ -0,0 +1,169 @@
+//  blend.cpp
+//  E64
+//
+//  Copyright © 2022 elmerucr. All rights reserved.
+//
+//  See video.hpp for a derivation of the blend formula. Per channel:
+//
+//  a_src     = alpha_src + 1
+//  a_src_inv = 17 - a_src
+//  alpha     = (256 - (a_src_inv * (16 - alpha_dest))) >> 4
+//  channel   = ((a_src * channel_src) + (a_src_inv * channel_dest)) >> 4
+//
+//  No intermediate value exceeds 16 bits, so the vector versions work
+//  on 8 (SSE2) or 16 (AVX2) pixels at once in 16 bit lanes.
+//
+//  Two classes of source pixels need no math at all. With alpha 0xf
+//  the formula reduces to destination = source, with alpha 0x0 the
+//  destination stays as it is. Both are checked per pixel (scalar) or
+//  per group of pixels (vector).
+
+#include "blend.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BLEND_X86
+#include <immintrin.h>
+#endif
+
+static void alpha_blend_row_scalar(uint16_t *destination, const uint16_t *source, uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		uint16_t s = source[i];
+
+		switch (s & 0xf000) {
+		case 0xf000:
+			destination[i] = s;
+			continue;
+		case 0x0000:
+			continue;
+		}
+
+		uint16_t d = destination[i];
+
+		uint16_t a_src = (s >> 12) + 1;
+		uint16_t a_src_inv = 17 - a_src;
+
+		uint16_t a = (256 - (a_src_inv * (16 - (d >> 12)))) >> 4;
+		uint16_t r = ((a_src * ((s >> 8) & 0xf)) + (a_src_inv * ((d >> 8) & 0xf))) >> 4;
+		uint16_t g = ((a_src * ((s >> 4) & 0xf)) + (a_src_inv * ((d >> 4) & 0xf))) >> 4;
+		uint16_t b = ((a_src * (s & 0xf)) + (a_src_inv * (d & 0xf))) >> 4;
+
+		destination[i] = (a << 12) | (r << 8) | (g << 4) | b;
+	}
+}
+
+#ifdef BLEND_X86
+
+__attribute__((target("sse2")))
+static void alpha_blend_row_sse2(uint16_t *destination, const uint16_t *source, uint32_t n)
+{
+	const __m128i nibble = _mm_set1_epi16(0xf);
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i sixteen = _mm_set1_epi16(16);
+	const __m128i seventeen = _mm_set1_epi16(17);
+	const __m128i max = _mm_set1_epi16(256);
+	const __m128i alpha = _mm_set1_epi16((short)0xf000);
+	const __m128i zero = _mm_setzero_si128();
+
+	uint32_t i = 0;
+
+	for (; i + 8 <= n; i += 8) {
+		__m128i s = _mm_loadu_si128((const __m128i *)&source[i]);
+		__m128i a_s = _mm_and_si128(s, alpha);
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(a_s, alpha)) == 0xffff) {
+			_mm_storeu_si128((__m128i *)&destination[i], s);
+			continue;
+		}
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(a_s, zero)) == 0xffff) continue;
+
+		__m128i d = _mm_loadu_si128((const __m128i *)&destination[i]);
+
+		__m128i a_src = _mm_add_epi16(_mm_srli_epi16(s, 12), one);
+		__m128i a_src_inv = _mm_sub_epi16(seventeen, a_src);
+
+		__m128i a = _mm_srli_epi16(_mm_sub_epi16(max,
+			_mm_mullo_epi16(a_src_inv, _mm_sub_epi16(sixteen, _mm_srli_epi16(d, 12)))), 4);
+		__m128i r = _mm_srli_epi16(_mm_add_epi16(
+			_mm_mullo_epi16(a_src, _mm_and_si128(_mm_srli_epi16(s, 8), nibble)),
+			_mm_mullo_epi16(a_src_inv, _mm_and_si128(_mm_srli_epi16(d, 8), nibble))), 4);
+		__m128i g = _mm_srli_epi16(_mm_add_epi16(
+			_mm_mullo_epi16(a_src, _mm_and_si128(_mm_srli_epi16(s, 4), nibble)),
+			_mm_mullo_epi16(a_src_inv, _mm_and_si128(_mm_srli_epi16(d, 4), nibble))), 4);
+		__m128i b = _mm_srli_epi16(_mm_add_epi16(
+			_mm_mullo_epi16(a_src, _mm_and_si128(s, nibble)),
+			_mm_mullo_epi16(a_src_inv, _mm_and_si128(d, nibble))), 4);
+
+		__m128i result = _mm_or_si128(
+			_mm_or_si128(_mm_slli_epi16(a, 12), _mm_slli_epi16(r, 8)),
+			_mm_or_si128(_mm_slli_epi16(g, 4), b));
+
+		_mm_storeu_si128((__m128i *)&destination[i], result);
+	}
+
+	alpha_blend_row_scalar(&destination[i], &source[i], n - i);
+}
+
+__attribute__((target("avx2")))
+static void alpha_blend_row_avx2(uint16_t *destination, const uint16_t *source, uint32_t n)
+{
+	const __m256i nibble = _mm256_set1_epi16(0xf);
+	const __m256i one = _mm256_set1_epi16(1);
+	const __m256i sixteen = _mm256_set1_epi16(16);
+	const __m256i seventeen = _mm256_set1_epi16(17);
+	const __m256i max = _mm256_set1_epi16(256);
+	const __m256i alpha = _mm256_set1_epi16((short)0xf000);
+	const __m256i zero = _mm256_setzero_si256();
+
+	uint32_t i = 0;
+
+	for (; i + 16 <= n; i += 16) {
+		__m256i s = _mm256_loadu_si256((const __m256i *)&source[i]);
+		__m256i a_s = _mm256_and_si256(s, alpha);
+
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(a_s, alpha)) == -1) {
+			_mm256_storeu_si256((__m256i *)&destination[i], s);
+			continue;
+		}
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(a_s, zero)) == -1) continue;
+
+		__m256i d = _mm256_loadu_si256((const __m256i *)&destination[i]);
+
+		__m256i a_src = _mm256_add_epi16(_mm256_srli_epi16(s, 12), one);
+		__m256i a_src_inv = _mm256_sub_epi16(seventeen, a_src);
+
+		__m256i a = _mm256_srli_epi16(_mm256_sub_epi16(max,
+			_mm256_mullo_epi16(a_src_inv, _mm256_sub_epi16(sixteen, _mm256_srli_epi16(d, 12)))), 4);
+		__m256i r = _mm256_srli_epi16(_mm256_add_epi16(
+			_mm256_mullo_epi16(a_src, _mm256_and_si256(_mm256_srli_epi16(s, 8), nibble)),
+			_mm256_mullo_epi16(a_src_inv, _mm256_and_si256(_mm256_srli_epi16(d, 8), nibble))), 4);
+		__m256i g = _mm256_srli_epi16(_mm256_add_epi16(
+			_mm256_mullo_epi16(a_src, _mm256_and_si256(_mm256_srli_epi16(s, 4), nibble)),
+			_mm256_mullo_epi16(a_src_inv, _mm256_and_si256(_mm256_srli_epi16(d, 4), nibble))), 4);
+		__m256i b = _mm256_srli_epi16(_mm256_add_epi16(
+			_mm256_mullo_epi16(a_src, _mm256_and_si256(s, nibble)),
+			_mm256_mullo_epi16(a_src_inv, _mm256_and_si256(d, nibble))), 4);
+
+		__m256i result = _mm256_or_si256(
+			_mm256_or_si256(_mm256_slli_epi16(a, 12), _mm256_slli_epi16(r, 8)),
+			_mm256_or_si256(_mm256_slli_epi16(g, 4), b));
+
+		_mm256_storeu_si256((__m256i *)&destination[i], result);
+	}
+
+	alpha_blend_row_sse2(&destination[i], &source[i], n - i);
+}
+
+#endif
+
+static void (*select_alpha_blend_row())(uint16_t *, const uint16_t *, uint32_t)
+{
+#ifdef BLEND_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return alpha_blend_row_avx2;
+	if (__builtin_cpu_supports("sse2")) return alpha_blend_row_sse2;
+#endif
+	return alpha_blend_row_scalar;
+}
+
+void (*E64::alpha_blend_row)(uint16_t *destination, const uint16_t *source, uint32_t n) = select_alpha_blend_row();
@@ -0,0 +1,23 @@
+//  blend.hpp
+//  E64
+//
+//  Copyright © 2022 elmerucr. All rights reserved.
+
+#include <cstdint>
+
+#ifndef BLEND_HPP
+#define BLEND_HPP
+
+namespace E64
+{
+
+/*
+ * Blends n source pixels onto n destination pixels (ARGB4444). Results
+ * are bit identical to video_t::alpha_blend. Depending on the host cpu
+ * (detected at runtime) it points to an AVX2, SSE2 or scalar version.
+ */
+extern void (*alpha_blend_row)(uint16_t *destination, const uint16_t *source, uint32_t n);
+
+}
+
+#endif
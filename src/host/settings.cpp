@@ -96,6 +96,27 @@ E64::settings_t::settings_t()
 		scanlines_at_init = true;
 	}
 	
+	lua_getglobal(L, "blitter_threads");
+	if (lua_isinteger(L, -1)) {
+		blitter_threads = (int)lua_tointeger(L, -1);
+	} else {
+		blitter_threads = 0;
+	}
+	
+	lua_getglobal(L, "blitter_pipelined");
+	if (lua_isboolean(L, -1)) {
+		blitter_pipelined = lua_toboolean(L, -1);
+	} else {
+		blitter_pipelined = false;
+	}
+	
+	lua_getglobal(L, "m68k");
+	if (lua_isboolean(L, -1)) {
+		m68k_enabled = lua_toboolean(L, -1);
+	} else {
+		m68k_enabled = false;
+	}
+	
 	lua_close(L);
 	
 	/*
@@ -160,6 +181,20 @@ void E64::settings_t::write_settings()
 			fwrite("\nscanlines = false", 1, 18, temp_file);
 		}
 		
+		fprintf(temp_file, "\nblitter_threads = %i", blitter_threads);
+		
+		if (blitter_pipelined) {
+			fwrite("\nblitter_pipelined = true", 1, 25, temp_file);
+		} else {
+			fwrite("\nblitter_pipelined = false", 1, 26, temp_file);
+		}
+		
+		if (machine.m68k_active()) {
+			fwrite("\nm68k = true", 1, 12, temp_file);
+		} else {
+			fwrite("\nm68k = false", 1, 13, temp_file);
+		}
+		
 		fclose(temp_file);
 	}
 }
@@ -66,6 +66,9 @@ public:
 	bool fullscreen_at_init;
 	char game_dir_at_init[256];
 	bool scanlines_at_init;
+	int  blitter_threads;	// band parallel blitter, 0 or 1 is off
+	bool blitter_pipelined;	// blitter draws while the cpu runs the next frame
+	bool m68k_enabled;	// 68000 available to the guest
 	
 	bool create_wav();
 	
@@ -5,11 +5,16 @@
 
 #include "video.hpp"
 #include "common.hpp"
+#include "blend.hpp"
 #include <cstring>
+#include <algorithm>
 
 E64::video_t::video_t()
 {
-	framebuffer = new uint16_t[TOTAL_PIXELS];
+	/*
+	 * Only needed when the streaming texture can't be locked
+	 */
+	framebuffer = nullptr;
 	overlay_buffer = new uint16_t[PIXELS_PER_SCANLINE * 4 * SCANLINES];
 	
 	SDL_version compiled;
@@ -175,14 +180,37 @@ E64::video_t::~video_t()
 //	memset(framebuffer, 0, TOTAL_PIXELS * sizeof(*framebuffer));
 //}
 
-void E64::video_t::merge_down_layer(uint16_t *buffer)
+void E64::video_t::composite(const struct layer_t *layers, int no_of_layers)
 {
-	uint16_t *temp = framebuffer;
-	
-	for (int i=0; i < TOTAL_PIXELS; i++) {
-		alpha_blend(temp, buffer);
-		temp++;
-		buffer++;
+	void *pixels;
+	int pitch;
+
+	if (SDL_LockTexture(texture, NULL, &pixels, &pitch) == 0) {
+		composite_into((uint8_t *)pixels, pitch, layers, no_of_layers);
+		SDL_UnlockTexture(texture);
+	} else {
+		/*
+		 * Fallback for renderers that don't support locking
+		 */
+		if (framebuffer == nullptr) framebuffer = new uint16_t[TOTAL_PIXELS];
+		composite_into((uint8_t *)framebuffer, PIXELS_PER_SCANLINE * sizeof(uint16_t), layers, no_of_layers);
+		SDL_UpdateTexture(texture, NULL, framebuffer,
+			PIXELS_PER_SCANLINE * sizeof(uint16_t));
+	}
+}
+
+void E64::video_t::composite_into(uint8_t *pixels, int pitch, const struct layer_t *layers, int no_of_layers)
+{
+	for (int y = 0; y < SCANLINES; y++) {
+		uint16_t *row = (uint16_t *)(pixels + (y * pitch));
+		uint32_t start = y * PIXELS_PER_SCANLINE;
+
+		std::fill_n(row, PIXELS_PER_SCANLINE, C64_BLACK);
+
+		for (int i = 0; i < no_of_layers; i++) {
+			if (layers[i].transparent) continue;
+			alpha_blend_row(row, &layers[i].buffer[start], PIXELS_PER_SCANLINE);
+		}
 	}
 }
 
@@ -190,9 +218,6 @@ void E64::video_t::update_screen()
 {
 	//SDL_RenderClear(renderer);
 
-	SDL_UpdateTexture(texture, NULL, framebuffer,
-		PIXELS_PER_SCANLINE * sizeof(uint16_t));
-    
 	SDL_RenderCopy(renderer, texture, NULL, NULL);
 	
 	if (using_scanlines) {
@@ -43,10 +43,22 @@
  *
  * Update 2022-03-25, added as public member function in video_t class
  *
+ * Update 2022-10-16, for whole rows of pixels see alpha_blend_row in
+ * blend.hpp (vectorized, same results)
+ *
  */
 
 namespace E64 {
 
+/*
+ * A layer for the compositor. If transparent is true (all pixels have
+ * alpha 0x0), the layer is skipped.
+ */
+struct layer_t {
+	uint16_t *buffer;
+	bool transparent;
+};
+
 struct window_size {
 	uint16_t x;
 	uint16_t y;
@@ -72,8 +84,10 @@ private:
 	int window_width;
 	int window_height;
 	
-	uint16_t *framebuffer;
+	uint16_t *framebuffer;		// fallback, if texture can't be locked
 	uint16_t *overlay_buffer;
+
+	void composite_into(uint8_t *pixels, int pitch, const struct layer_t *layers, int no_of_layers);
 	
 	bool using_scanlines;
 public:
@@ -108,7 +122,13 @@ public:
 	}
 
 	//void clear_frame_buffer();
-	void merge_down_layer(uint16_t *buffer);
+
+	/*
+	 * Blends a list of layers (bottom one first) onto an opaque black
+	 * base in one pass, scanline by scanline, straight into the locked
+	 * streaming texture.
+	 */
+	void composite(const struct layer_t *layers, int no_of_layers);
 	void update_screen();
 	void update_title();
 	void reset_window_size();
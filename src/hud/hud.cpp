@@ -40,10 +40,11 @@ bool E64::hud_t::hex_string_to_int(const char *temp_string, uint32_t *return_val
 
 E64::hud_t::hud_t()
 {
-	exceptions = new exceptions_ic();
-	blitter = new blitter_ic();
-	cia = new cia_ic();
-	timer = new timer_ic(exceptions);
+	scheduler = new scheduler_t();
+	exceptions = new exceptions_ic(&scheduler_t::now_of, scheduler);
+	blitter = new blitter_ic(false);
+	cia = new cia_ic(scheduler);
+	timer = new timer_ic(exceptions, scheduler);
 	
 	stats_view = &blitter->blit[0];
 	blitter->terminal_init(stats_view->number, 0x8a, 0x00, 0x58, 0x33, GREEN_05,
@@ -106,10 +107,13 @@ E64::hud_t::~hud_t()
 	delete cia;
 	delete blitter;
 	delete exceptions;
+	delete scheduler;
 }
 
 void E64::hud_t::reset()
 {
+	scheduler->reset();
+	
 	blitter->reset();
 	blitter->set_clear_color(0x0000);
 	blitter->set_hor_border_color(0x0000);
@@ -245,14 +249,29 @@ void E64::hud_t::update()
 	blitter->terminal_clear(other_info->number);
 	//other_info->terminal_clear();
 	blitter->terminal_printf(other_info->number, " IRQ lines: blitter(%c) timer(%c)",
-			   machine.exceptions->irq_input_pins[machine.blitter->irq_number] ? '1' : '0',
-			   machine.exceptions->irq_input_pins[machine.timer->irq_number] ? '1' : '0');
+			   machine.exceptions->irq_input_pin(machine.blitter->irq_number) ? '1' : '0',
+			   machine.exceptions->irq_input_pin(machine.timer->irq_number) ? '1' : '0');
 	blitter->terminal_printf(other_info->number, "\n\n cycles done: %u of %u", machine.frame_cycles(), CPU_CYCLES_PER_FRAME);
+	blitter->terminal_printf(other_info->number, "\n dropped blit operations: %u", machine.blitter->get_operations_dropped());
 }
 
 void E64::hud_t::run(uint16_t cycles)
 {
-	timer->run(cycles);
+	/*
+	 * The hud has no cpu, its scheduler is moved forward by hand
+	 */
+	scheduler->advance(cycles);
+	
+	event_t event;
+	
+	while ((event = scheduler->pop_due()) != NO_OF_EVENTS) {
+		if (event == EVENT_CIA) {
+			cia->event();
+		} else {
+			timer->event(event - EVENT_TIMER0);
+		}
+	}
+	
 	if (exceptions->irq_output_pin == false) {
 		for (int i=0; i<8; i++) {
 			if (timer->io_read_byte(0x00) & (0b1 << i)) {
@@ -277,8 +296,6 @@ void E64::hud_t::run(uint16_t cycles)
 		}
 	}
 	
-	cia->run(cycles);
-	
 	frame_cycle_saldo += cycles;
 	
 	if (frame_cycle_saldo > CPU_CYCLES_PER_FRAME) {
@@ -536,9 +553,30 @@ void E64::hud_t::process_command(char *buffer)
 				}
 			}
 		}
+	} else if (strcmp(token0, "m68k") == 0) {
+		token1 = strtok(NULL, " ");
+		if (token1 != NULL) {
+			if (strcmp(token1, "on") == 0) {
+				machine.set_m68k(true);
+			} else if (strcmp(token1, "off") == 0) {
+				machine.set_m68k(false);
+			}
+		}
+		blitter->terminal_printf(terminal->number, "\n68000 %s", !machine.m68k_active() ? "off" :
+					 machine.m68k->running() ? "on, running" : "on, held in reset");
 	} else if (strcmp(token0, "reset") == 0) {
 		E64::sdl2_wait_until_enter_released();
 		machine.reset();
+	} else if (strcmp(token0, "irqs") == 0) {
+		token1 = strtok(NULL, " ");
+		if ((token1 != NULL) && (strcmp(token1, "reset") == 0)) {
+			machine.exceptions->reset_latencies();
+		}
+		for (int i=0; i<8; i++) {
+			char text_buffer[64];
+			machine.exceptions->status(text_buffer, i);
+			blitter->terminal_puts(terminal->number, text_buffer);
+		}
 	} else if (strcmp(token0, "timers") == 0) {
 		for (int i=0; i<8; i++) {
 			char text_buffer[64];
@@ -5,6 +5,7 @@
 #include "cia.hpp"
 #include "timer.hpp"
 #include "exceptions.hpp"
+#include "scheduler.hpp"
 
 #ifndef HUD_HPP
 #define HUD_HPP
@@ -41,6 +42,7 @@ public:
 	void enter_monitor_blit_line(char *buffer);
 	bool hex_string_to_int(const char *temp_string, uint32_t *return_value);
 	
+	scheduler_t *scheduler;
 	exceptions_ic *exceptions;
 	blitter_ic *blitter;
 	cia_ic *cia;
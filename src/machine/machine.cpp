@@ -15,6 +15,8 @@
 #define MACHINE_SR	0x00
 #define MACHINE_CR	0x01
 
+#define SOUND_FLUSH_CYCLES	512
+
 static int pokeb(lua_State *L)
 {
 	uint16_t address = lua_tonumber(L, 1);
@@ -23,47 +25,59 @@ static int pokeb(lua_State *L)
 	return 0;	// no of results
 }
 
-/*
- * mmu glue function needed for MC6809 constructor
- */
-inline uint8_t read8(uint16_t address)
-{
-	return machine.mmu->read_memory_8(address);
-}
-
-/*
- * mmu glue function needed for MC6809 constructor
- */
-inline void write8(uint16_t address, uint8_t byte)
-{
-	machine.mmu->write_memory_8(address, byte);
-}
-
 E64::machine_t::machine_t()
 {
 	underruns = equalruns = overruns = 1;
 	under_lap = equal_lap = over_lap = 1;
 	
+	scheduler = new scheduler_t();
+	
 	mmu = new mmu_ic();
 	
 	SN74LS612 = new SN74LS612_t();
 	
-	exceptions = new exceptions_ic();
+	exceptions = new exceptions_ic(&scheduler_t::now_of, scheduler);
 	
-	cpu = new mc6809(read8, write8);
+	cpu = new mc6809_t<mmu_bus_t>();
 	cpu->assign_nmi_line(&exceptions->nmi_output_pin);
 	cpu->assign_irq_line(&exceptions->irq_output_pin);
+	cpu->assign_attention_line(&exceptions->attention);
+	scheduler->connect_cpu(cpu);
+	
+	/*
+	 * Devices only act on events in between cpu runs, so loops polling
+	 * ram, or i/o registers that read without side effects (like the
+	 * rom waiting for a key on an empty cia fifo), can be skipped up to
+	 * the next event. Loops that pop events (draining the cia fifo)
+	 * run as usual.
+	 */
+	cpu->set_idle_loops(true);
+	cpu->assign_side_effect_free_read(&mmu_ic::side_effect_free, mmu);
+	
+	/*
+	 * Hot blocks run as native code where the host supports it, with
+	 * the memory pages mapped by the mmu.
+	 */
+	cpu->set_jit(true);
 	
+	/*
+	 * The 68000 is held in reset until the guest releases it, see
+	 * m68k.hpp
+	 */
 	m68k = new m68k_ic();
+	m68k->set_available(host.settings->m68k_enabled);
 	
-	timer = new timer_ic(exceptions);
+	timer = new timer_ic(exceptions, scheduler);
 	
 	blitter = new blitter_ic();
 	blitter->connect_exceptions_ic(exceptions);
+	blitter->connect_mmu_ic(mmu);
+	blitter->set_threads(host.settings->blitter_threads);
+	blitter->set_pipelined(host.settings->blitter_pipelined);
 	
 	sound = new sound_ic();
 	
-	cia = new cia_ic();
+	cia = new cia_ic(scheduler);
 	
 	/*
 	 * Init clocks (frequency dividers)
@@ -114,33 +128,38 @@ E64::machine_t::~machine_t()
 	delete exceptions;
 	delete SN74LS612;
 	delete mmu;
+	delete scheduler;
 }
 
 bool E64::machine_t::run(uint16_t cycles)
 {
 	cpu_cycle_saldo += cycles;
-	m68k_cycle_saldo += cycles;
 	
 	/*
-	 * A fine grained cycles_step is needed to be able run the
-	 * proper amount of cycles on both cia and timer after each
-	 * cpu instruction. That way, there'll be a decent emulation
-	 * of interrupt triggering and acknowledgements.
+	 * The cpu runs uninterrupted up to the next deadline in the
+	 * scheduler, or until the desired amount of cycles is done. Events
+	 * of timers, cia, sound and frame are handled in between runs. As
+	 * these are the only ones pulling interrupt lines, the cpu sees an
+	 * interrupt at the start of its next run, just like it used to when
+	 * polling all devices after each instruction.
 	 *
-	 * Note: This implies that cia and timer run at the same clock
-	 * speed as the cpu.
+	 * A run of 0 cycles (debugger) executes exactly one instruction.
 	 */
-	uint8_t cycles_step;
-	
 	int32_t consumed_cycles = 0;
 	
 	do {
-		m68k->execute();
-		cycles_step = m68k->getClock();
-		cycles_step = cpu->execute();
-		cia->run(cycles_step);
-		timer->run(cycles_step);
-		consumed_cycles += cycles_step;
+		uint32_t budget = scheduler->cycles_to_next_deadline();
+		int32_t remaining = cpu_cycle_saldo - consumed_cycles;
+		if (remaining < 0) remaining = 0;
+		if ((uint32_t)remaining < budget) budget = remaining;
+		
+		uint32_t done = cpu->run(budget);
+		scheduler->advance(done);
+		consumed_cycles += done;
+		
+		m68k->run(done);
+		
+		process_events();
 	} while ((!cpu->breakpoint()) && (consumed_cycles < cpu_cycle_saldo));
 	
 	/*
@@ -154,7 +173,36 @@ bool E64::machine_t::run(uint16_t cycles)
 	} else {
 		cpu_cycle_saldo -= consumed_cycles;
 	}
+	
+	return cpu->breakpoint();
+}
+
+void E64::machine_t::process_events()
+{
+	event_t event;
+	
+	while ((event = scheduler->pop_due()) != NO_OF_EVENTS) {
+		switch (event) {
+			case EVENT_CIA:
+				cia->event();
+				break;
+			case EVENT_SOUND:
+				flush_sound();
+				break;
+			case EVENT_FRAME:
+				finish_frame();
+				break;
+			default:
+				timer->event(event - EVENT_TIMER0);
+				break;
+		}
+	}
+}
 
+void E64::machine_t::flush_sound()
+{
+	scheduler->schedule(EVENT_SOUND, scheduler->deadline(EVENT_SOUND) + SOUND_FLUSH_CYCLES);
+	
 	/*
 	 * Run cycles on sound device & start audio if buffer is large
 	 * enough. The aim is to have as much synchronization between
@@ -168,13 +216,13 @@ bool E64::machine_t::run(uint16_t cycles)
 	if (!recording_sound) {
 		/* not recording sound */
 		if (audio_queue_size < (0.5 * AUDIO_BUFFER_SIZE)) {
-			sound->run(cpu_to_sid->clock(1.05 * consumed_cycles));
+			sound->run(cpu_to_sid->clock(1.05 * SOUND_FLUSH_CYCLES));
 			underruns++;
 		} else if (audio_queue_size < 1.2 * AUDIO_BUFFER_SIZE) {
-			sound->run(cpu_to_sid->clock(consumed_cycles));
+			sound->run(cpu_to_sid->clock(SOUND_FLUSH_CYCLES));
 			equalruns++;
 		} else if (audio_queue_size < 2.0 * AUDIO_BUFFER_SIZE) {
-			sound->run(cpu_to_sid->clock(0.95 * consumed_cycles));
+			sound->run(cpu_to_sid->clock(0.95 * SOUND_FLUSH_CYCLES));
 			overruns++;
 		} else overruns++;
 	} else {
@@ -187,7 +235,7 @@ bool E64::machine_t::run(uint16_t cycles)
 			overruns++;
 		}
 		
-		sound->run(cpu_to_sid->clock(consumed_cycles));
+		sound->run(cpu_to_sid->clock(SOUND_FLUSH_CYCLES));
 		
 		float sample;
 		
@@ -198,32 +246,33 @@ bool E64::machine_t::run(uint16_t cycles)
 	
 	if (audio_queue_size > (3*AUDIO_BUFFER_SIZE/4))
 		E64::sdl2_start_audio();
+}
+
+void E64::machine_t::finish_frame()
+{
+	scheduler->schedule(EVENT_FRAME, scheduler->deadline(EVENT_FRAME) + CPU_CYCLES_PER_FRAME);
 	
-	frame_cycle_saldo += consumed_cycles;
+	frame_is_done = true;
 	
-	if (frame_cycle_saldo > CPU_CYCLES_PER_FRAME) {
-		frame_is_done = true;
-		
-		/*
-		 * Warn blitter for possible IRQ pull
-		 */
-		blitter->notify_screen_refreshed();
-		
-		
-		frame_cycle_saldo -= CPU_CYCLES_PER_FRAME;
-		
-		/*
-		 * run Lua update, might add some more blits
-		 */
-		lua_update();
-		
-		/*
-		 * Then run blitter
-		 */
-		blitter->run(BLIT_CYCLES_PER_FRAME);
-	}
+	/*
+	 * Warn blitter for possible IRQ pull
+	 */
+	blitter->notify_screen_refreshed();
 	
-	return cpu->breakpoint();
+	/*
+	 * run Lua update, might add some more blits
+	 */
+	lua_update();
+	
+	/*
+	 * Then run blitter
+	 */
+	blitter->run(BLIT_CYCLES_PER_FRAME);
+}
+
+int32_t E64::machine_t::frame_cycles()
+{
+	return scheduler->now() - (scheduler->deadline(EVENT_FRAME) - CPU_CYCLES_PER_FRAME);
 }
 
 void E64::machine_t::reset()
@@ -231,18 +280,20 @@ void E64::machine_t::reset()
 	printf("[Machine] System reset\n");
 	
 	cpu_cycle_saldo = 0;
-	m68k_cycle_saldo = 0;
-	frame_cycle_saldo = 0;
 	frame_is_done = false;
 	
-	mmu->reset();
+	scheduler->reset();
+	scheduler->schedule(EVENT_SOUND, SOUND_FLUSH_CYCLES);
+	scheduler->schedule(EVENT_FRAME, CPU_CYCLES_PER_FRAME);
+	
 	SN74LS612->reset();
+	mmu->reset();
 	sound->reset();
 	blitter->reset();
 	timer->reset();
 	cia->reset();
 	cpu->reset();
-	m68k->reset();
+	m68k->reset_registers();
 	
 	lua_initialized = false;
 }
@@ -282,6 +333,12 @@ bool E64::machine_t::buffer_within_specs()
 	return result;
 }
 
+void E64::machine_t::set_m68k(bool value)
+{
+	m68k->set_available(value);
+	printf("[Machine] 68000 %s\n", value ? "available" : "not available");
+}
+
 void E64::machine_t::flip_modes()
 {
 	if (mode == RUNNING) {
@@ -10,6 +10,7 @@
 
 #include "cia.hpp"
 #include "clocks.hpp"
+#include "scheduler.hpp"
 #include "mmu.hpp"
 #include "SN74LS612.hpp"
 #include "sound.hpp"
@@ -33,10 +34,15 @@ private:
 	clocks *cpu_to_sid;
 	char machine_help_string[2048];
 	int32_t cpu_cycle_saldo;
-	int32_t m68k_cycle_saldo;
-	int32_t frame_cycle_saldo;
 	bool frame_is_done;
 	
+	/*
+	 * Handlers for events from the scheduler
+	 */
+	void process_events();
+	void flush_sound();
+	void finish_frame();
+	
 	/*
 	 * Keeping track of soundbuffer and its performance
 	 */
@@ -50,10 +56,11 @@ private:
 public:
 	enum mode_t mode;
 
+	scheduler_t	*scheduler;
 	mmu_ic		*mmu;
 	SN74LS612_t	*SN74LS612;
 	exceptions_ic	*exceptions;
-	mc6809		*cpu;
+	mc6809_t<mmu_bus_t>	*cpu;
 	m68k_ic		*m68k;
 	timer_ic	*timer;
 	blitter_ic	*blitter;
@@ -69,6 +76,13 @@ public:
 	
 	void flip_modes();
 	
+	/*
+	 * Makes the 68000 available to the guest, which releases it from
+	 * reset. Taking it away holds it in reset.
+	 */
+	void set_m68k(bool value);
+	inline bool m68k_active() { return m68k->is_available(); }
+	
 	inline bool frame_done() {
 		bool result = frame_is_done;
 		if (frame_is_done)
@@ -76,7 +90,7 @@ public:
 		return result;
 	}
 	
-	inline int32_t frame_cycles() { return frame_cycle_saldo; }
+	int32_t frame_cycles();
 	
 	/*
 	 * Sound related
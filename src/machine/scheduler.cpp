@@ -0,0 +1,136 @@
+/*
+ * scheduler.cpp
+ * E64
+ *
+ * Copyright © 2022 elmerucr. All rights reserved.
+ */
+
+#include "scheduler.hpp"
+#include "mmu.hpp"
+#include "mc6809.hpp"
+
+E64::scheduler_t::scheduler_t()
+{
+	cpu = nullptr;
+	reset();
+}
+
+void E64::scheduler_t::reset()
+{
+	for (int i=0; i<NO_OF_EVENTS; i++) {
+		deadlines[i] = SCHEDULER_NEVER;
+		position[i] = NO_OF_EVENTS;
+	}
+	heap_size = 0;
+
+	clock = 0;
+	cpu_ticks = cpu ? cpu->clock_ticks() : 0;
+}
+
+void E64::scheduler_t::connect_cpu(mc6809_t<mmu_bus_t> *unit)
+{
+	cpu = unit;
+	cpu_ticks = cpu->clock_ticks();
+}
+
+uint64_t E64::scheduler_t::now()
+{
+	return cpu ? clock + (uint32_t)(cpu->clock_ticks() - cpu_ticks) : clock;
+}
+
+void E64::scheduler_t::advance(uint32_t cycles)
+{
+	clock += cycles;
+	if (cpu) cpu_ticks = cpu->clock_ticks();
+}
+
+void E64::scheduler_t::place(uint8_t index, uint8_t event)
+{
+	heap[index] = event;
+	position[event] = index;
+}
+
+void E64::scheduler_t::sift_up(uint8_t index)
+{
+	uint8_t event = heap[index];
+
+	while (index) {
+		uint8_t parent = (index - 1) / 2;
+		if (!earlier(event, heap[parent])) break;
+		place(index, heap[parent]);
+		index = parent;
+	}
+	place(index, event);
+}
+
+void E64::scheduler_t::sift_down(uint8_t index)
+{
+	uint8_t event = heap[index];
+
+	for (;;) {
+		uint8_t child = (2 * index) + 1;
+		if (child >= heap_size) break;
+		if ((child + 1 < heap_size) && earlier(heap[child + 1], heap[child])) child++;
+		if (!earlier(heap[child], event)) break;
+		place(index, heap[child]);
+		index = child;
+	}
+	place(index, event);
+}
+
+void E64::scheduler_t::schedule(event_t event, uint64_t deadline)
+{
+	bool sooner = deadline < next_deadline();
+
+	deadlines[event] = deadline;
+
+	if (position[event] == NO_OF_EVENTS) {
+		place(heap_size++, event);
+	}
+	sift_up(position[event]);
+	sift_down(position[event]);
+
+	/*
+	 * The cpu may be running towards a later deadline, make it return
+	 * in time.
+	 */
+	if (sooner && cpu) cpu->limit_run(cycles_to_next_deadline());
+}
+
+void E64::scheduler_t::remove(uint8_t event)
+{
+	uint8_t index = position[event];
+
+	position[event] = NO_OF_EVENTS;
+
+	if (index != --heap_size) {
+		uint8_t moved = heap[heap_size];
+		place(index, moved);
+		sift_up(index);
+		if (heap[index] == moved) sift_down(index);
+	}
+}
+
+void E64::scheduler_t::cancel(event_t event)
+{
+	if (position[event] != NO_OF_EVENTS) remove(event);
+	deadlines[event] = SCHEDULER_NEVER;
+}
+
+uint32_t E64::scheduler_t::cycles_to_next_deadline()
+{
+	uint64_t current = now();
+	uint64_t next = next_deadline();
+
+	if (next <= current) return 0;
+	return (next - current) > INT32_MAX ? INT32_MAX : (uint32_t)(next - current);
+}
+
+E64::event_t E64::scheduler_t::pop_due()
+{
+	if ((heap_size == 0) || (deadlines[heap[0]] > now())) return NO_OF_EVENTS;
+
+	event_t event = (event_t)heap[0];
+	remove(event);
+	return event;
+}
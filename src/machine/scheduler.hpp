@@ -0,0 +1,112 @@
+/*
+ * scheduler.hpp
+ * E64
+ *
+ * Copyright © 2022 elmerucr. All rights reserved.
+ */
+
+/*
+ * The scheduler keeps the deadlines of all timed events of a machine,
+ * counted in cycles since reset. Deadlines live in a binary min-heap,
+ * so the cpu can run uninterrupted up to the earliest one, instead of
+ * polling every device after each instruction.
+ *
+ * Devices derive their counters lazily from now(), and (re)schedule
+ * their event whenever a register write changes their timing. When a
+ * cpu is connected, now() includes the cycles of the run in progress,
+ * and an event scheduled before the next deadline shortens that run.
+ */
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <cstdint>
+
+#define SCHEDULER_NEVER	UINT64_MAX
+
+template <class bus_t> class mc6809_t;
+
+namespace E64
+{
+
+class mmu_bus_t;
+
+enum event_t {
+	EVENT_TIMER0,		// timer events must be consecutive
+	EVENT_TIMER1,
+	EVENT_TIMER2,
+	EVENT_TIMER3,
+	EVENT_TIMER4,
+	EVENT_TIMER5,
+	EVENT_TIMER6,
+	EVENT_TIMER7,
+	EVENT_CIA,
+	EVENT_SOUND,
+	EVENT_FRAME,
+	NO_OF_EVENTS
+};
+
+class scheduler_t {
+private:
+	uint64_t deadlines[NO_OF_EVENTS];
+	uint8_t heap[NO_OF_EVENTS];
+	uint8_t position[NO_OF_EVENTS];	// in heap, NO_OF_EVENTS if idle
+	uint8_t heap_size;
+
+	uint64_t clock;
+	uint32_t cpu_ticks;		// cpu clock_ticks() at clock
+	mc6809_t<mmu_bus_t> *cpu;
+
+	/*
+	 * Equal deadlines are ordered by event number, keeping the order
+	 * of events deterministic.
+	 */
+	inline bool earlier(uint8_t a, uint8_t b) {
+		return (deadlines[a] < deadlines[b]) ||
+		       ((deadlines[a] == deadlines[b]) && (a < b));
+	}
+	void place(uint8_t index, uint8_t event);
+	void sift_up(uint8_t index);
+	void sift_down(uint8_t index);
+	void remove(uint8_t event);
+public:
+	scheduler_t();
+	void reset();
+
+	void connect_cpu(mc6809_t<mmu_bus_t> *unit);
+
+	uint64_t now();
+	static uint64_t now_of(void *scheduler) { return ((scheduler_t *)scheduler)->now(); }
+
+	/*
+	 * Moves the clock forward after the cpu (or the caller, without
+	 * a cpu) has run a number of cycles.
+	 */
+	void advance(uint32_t cycles);
+
+	void schedule(event_t event, uint64_t deadline);
+	inline void schedule_in(event_t event, uint32_t cycles) { schedule(event, now() + cycles); }
+	void cancel(event_t event);
+
+	inline bool scheduled(event_t event) { return position[event] != NO_OF_EVENTS; }
+	inline uint64_t deadline(event_t event) { return deadlines[event]; }
+	inline uint64_t next_deadline() { return heap_size ? deadlines[heap[0]] : SCHEDULER_NEVER; }
+
+	/*
+	 * Cycles until the next deadline, 0 if it has passed already. Is
+	 * limited to INT32_MAX, a safe budget for a cpu run.
+	 */
+	uint32_t cycles_to_next_deadline();
+
+	/*
+	 * Removes and returns the earliest event if its deadline has been
+	 * reached, otherwise returns NO_OF_EVENTS. The deadline of a popped
+	 * event stays available, so periodic events can reschedule without
+	 * drift.
+	 */
+	event_t pop_due();
+};
+
+}
+
+#endif
@@ -89,8 +89,11 @@ static void finish_frame()
 	hud.blitter->flush();
 	
 	//host.video->clear_frame_buffer();
-	host.video->merge_down_layer(machine.blitter->fb);
-	host.video->merge_down_layer(hud.blitter->fb);
+	const struct E64::layer_t layers[] = {
+		{ machine.blitter->fb, machine.blitter->fb_is_transparent() },
+		{ hud.blitter->fb, hud.blitter->fb_is_transparent() }
+	};
+	host.video->composite(layers, 2);
 	
 	/*
 	 * "End of work": frame is done now